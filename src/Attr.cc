@@ -17,7 +17,7 @@ const char* attr_name(attr_tag t)
 		"&read_expire", "&write_expire", "&create_expire",
 		"&raw_output", "&priority",
 		"&group", "&log", "&error_handler", "&type_column",
-		"(&tracked)", "&on_change", "&deprecated",
+		"(&tracked)", "&on_change", "&broker_sync", "&deprecated",
 	};
 
 	return attr_names[int(t)];
@@ -549,6 +549,24 @@ void Attributes::CheckAttr(Attr* a)
 		}
 		break;
 
+	case ATTR_BROKER_SYNC:
+		if ( type->Tag() != TYPE_TABLE )
+			{
+			Error("&broker_sync only applicable to tables");
+			break;
+			}
+
+		if ( ! global_var )
+			{
+			Error("&broker_sync only applicable to global variables");
+			break;
+			}
+
+		if ( a->AttrExpr()->Type()->Tag() != TYPE_STRING ||
+		     ! a->AttrExpr()->IsConst() )
+			Error("&broker_sync requires a constant topic string");
+		break;
+
 	case ATTR_TRACKED:
 		// FIXME: Check here for global ID?
 		break;
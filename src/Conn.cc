@@ -108,6 +108,7 @@ Connection::Connection(NetSessions* s, const ConnIDKey& k, double t, const ConnI
 	finished = 0;
 
 	hist_seen = 0;
+	payload_bytes = 0;
 	history = "";
 
 	root_analyzer = nullptr;
@@ -197,6 +198,8 @@ void Connection::NextPacket(double t, bool is_orig,
 	if ( Skipping() )
 		return;
 
+	payload_bytes += len;
+
 	if ( root_analyzer )
 		{
 		auto was_successful = is_successful;
@@ -353,15 +356,15 @@ const IntrusivePtr<RecordVal>& Connection::ConnVal()
 		TransportProto prot_type = ConnTransport();
 
 		auto id_val = make_intrusive<RecordVal>(conn_id);
-		id_val->Assign(0, make_intrusive<AddrVal>(orig_addr));
-		id_val->Assign(1, val_mgr->Port(ntohs(orig_port), prot_type));
-		id_val->Assign(2, make_intrusive<AddrVal>(resp_addr));
-		id_val->Assign(3, val_mgr->Port(ntohs(resp_port), prot_type));
+		id_val->AssignAddr(0, orig_addr);
+		id_val->AssignPort(1, ntohs(orig_port), prot_type);
+		id_val->AssignAddr(2, resp_addr);
+		id_val->AssignPort(3, ntohs(resp_port), prot_type);
 
 		auto orig_endp = make_intrusive<RecordVal>(endpoint);
-		orig_endp->Assign(0, val_mgr->Count(0));
-		orig_endp->Assign(1, val_mgr->Count(0));
-		orig_endp->Assign(4, val_mgr->Count(orig_flow_label));
+		orig_endp->AssignUnsigned(0, 0);
+		orig_endp->AssignUnsigned(1, 0);
+		orig_endp->AssignUnsigned(4, orig_flow_label);
 
 		const int l2_len = sizeof(orig_l2_addr);
 		char null[l2_len]{};
@@ -370,9 +373,9 @@ const IntrusivePtr<RecordVal>& Connection::ConnVal()
 			orig_endp->Assign(5, make_intrusive<StringVal>(fmt_mac(orig_l2_addr, l2_len)));
 
 		auto resp_endp = make_intrusive<RecordVal>(endpoint);
-		resp_endp->Assign(0, val_mgr->Count(0));
-		resp_endp->Assign(1, val_mgr->Count(0));
-		resp_endp->Assign(4, val_mgr->Count(resp_flow_label));
+		resp_endp->AssignUnsigned(0, 0);
+		resp_endp->AssignUnsigned(1, 0);
+		resp_endp->AssignUnsigned(4, resp_flow_label);
 
 		if ( memcmp(&resp_l2_addr, &null, l2_len) != 0 )
 			resp_endp->Assign(5, make_intrusive<StringVal>(fmt_mac(resp_l2_addr, l2_len)));
@@ -393,20 +396,49 @@ const IntrusivePtr<RecordVal>& Connection::ConnVal()
 			conn_val->Assign(8, encapsulation->GetVectorVal());
 
 		if ( vlan != 0 )
-			conn_val->Assign(9, val_mgr->Int(vlan));
+			conn_val->AssignInt(9, vlan);
 
 		if ( inner_vlan != 0 )
-			conn_val->Assign(10, val_mgr->Int(inner_vlan));
+			conn_val->AssignInt(10, inner_vlan);
 
 		}
 
 	if ( root_analyzer )
 		root_analyzer->UpdateConnVal(conn_val.get());
 
-	conn_val->Assign(3, make_intrusive<Val>(start_time, TYPE_TIME));	// ###
-	conn_val->Assign(4, make_intrusive<Val>(last_time - start_time, TYPE_INTERVAL));
-	conn_val->Assign(6, make_intrusive<StringVal>(history.c_str()));
-	conn_val->Assign(11, val_mgr->Bool(is_successful));
+	// Consecutive events rarely change much about the connection, so
+	// leave alone whatever is still current.  In particular, this avoids
+	// building a new history string for every event.
+	int skipped = 0;
+
+	if ( conn_val->HasField(3) && conn_val->FieldDouble(3) == start_time )
+		++skipped;
+	else
+		conn_val->AssignDouble(3, start_time);	// ###
+
+	double duration = last_time - start_time;
+
+	if ( conn_val->HasField(4) && conn_val->FieldDouble(4) == duration )
+		++skipped;
+	else
+		conn_val->AssignDouble(4, duration);
+
+	const BroString* hist = conn_val->HasField(6) ?
+		conn_val->Lookup(6)->AsString() : nullptr;
+
+	if ( hist && hist->Len() == int(history.size()) &&
+	     memcmp(hist->Bytes(), history.data(), history.size()) == 0 )
+		++skipped;
+	else
+		conn_val->Assign(6, make_intrusive<StringVal>(history.c_str()));
+
+	if ( conn_val->HasField(11) && conn_val->FieldInt(11) == is_successful )
+		++skipped;
+	else
+		conn_val->AssignInt(11, is_successful);
+
+	++conn_val_updates;
+	conn_val_updates_skipped += skipped;
 
 	conn_val->SetOrigin(this);
 
@@ -148,6 +148,10 @@ public:
 	void SetSkip(bool do_skip)		{ skip = do_skip ? 1 : 0; }
 	bool Skipping() const			{ return skip; }
 
+	// Returns the number of IP payload bytes seen so far in both
+	// directions, not counting skipped packets.
+	uint64_t PayloadBytes() const		{ return payload_bytes; }
+
 	// Arrange for the connection to expire after the given amount of time.
 	void SetLifetime(double lifetime);
 
@@ -237,7 +241,7 @@ public:
 	  std::is_convertible_v<
 	    std::tuple_element_t<0, std::tuple<Args...>>, IntrusivePtr<Val>>>
 	EnqueueEvent(EventHandlerPtr h, analyzer::Analyzer* analyzer, Args&&... args)
-		{ return EnqueueEvent(h, analyzer, zeek::Args{std::forward<Args>(args)...}); }
+		{ return EnqueueEvent(h, analyzer, zeek::make_args(std::forward<Args>(args)...)); }
 
 	void Weird(const char* name, const char* addl = "");
 	bool DidWeird() const	{ return weird != 0; }
@@ -355,6 +359,7 @@ protected:
 	u_char resp_l2_addr[Packet::l2_addr_len];	// Link-layer responder address, if available
 	double start_time, last_time;
 	double inactivity_timeout;
+	uint64_t payload_bytes;
 	IntrusivePtr<RecordVal> conn_val;
 	LoginConn* login_conn;	// either nil, or this
 	const EncapsulationStack* encapsulation; // tunnels
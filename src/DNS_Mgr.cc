@@ -68,6 +68,7 @@ public:
 	// Returns nil if this was an address request.
 	const char* ReqHost() const	{ return host; }
 	const IPAddr& ReqAddr() const		{ return addr; }
+	int Family() const	{ return fam; }
 	bool ReqIsTxt() const	{ return qtype == 16; }
 
 	int MakeRequest(nb_dns_info* nb_dns);
@@ -134,7 +135,7 @@ public:
 
 	bool Expired() const
 		{
-		if ( req_host && num_addrs == 0)
+		if ( req_host && num_addrs == 0 && ! failed )
 			return false; // nothing to expire
 
 		return current_time() > (creation_time + req_ttl);
@@ -172,6 +173,24 @@ void DNS_Mgr_mapping_delete_func(void* v)
 	delete (DNS_Mapping*) v;
 	}
 
+static void delete_mappings(DNS_Mapping* dm)
+	{
+	delete dm;
+	}
+
+static void delete_mappings(const std::pair<DNS_Mapping*, DNS_Mapping*>& dms)
+	{
+	delete dms.first;
+	delete dms.second;
+	}
+
+static const char* mapping_name(const DNS_Mapping* dm)
+	{
+	// The escapes in the following strings are to avoid having it
+	// interpreted as a trigraph sequence.
+	return dm->names ? dm->names[0] : "<\?\?\?>";
+	}
+
 static IntrusivePtr<TableVal> empty_addr_set()
 	{
 	auto addr_t = base_type(TYPE_ADDR);
@@ -392,9 +411,22 @@ DNS_Mgr::DNS_Mgr(DNS_MgrMode arg_mode)
 	num_requests = 0;
 	successful = 0;
 	failed = 0;
+	cache_hits = 0;
+	cache_misses = 0;
+	coalesced = 0;
+	evicted = 0;
+	negative_ttl = 0;
+	max_cache_entries = 0;
 	nb_dns = nullptr;
 	}
 
+size_t DNS_Mgr::AddrHash::operator()(const IPAddr& addr) const
+	{
+	const uint32_t* bytes;
+	int len = addr.GetBytes(&bytes);
+	return KeyedHash::Hash64(bytes, len * sizeof(uint32_t));
+	}
+
 DNS_Mgr::~DNS_Mgr()
 	{
 	if ( nb_dns )
@@ -416,6 +448,8 @@ void DNS_Mgr::InitSource()
 	// the lookup.
 	auto dns_resolver = zeekenv("ZEEK_DNS_RESOLVER");
 	auto dns_resolver_addr = dns_resolver ? IPAddr(dns_resolver) : IPAddr();
+	auto dns_resolver_port = zeekenv("ZEEK_DNS_RESOLVER_PORT");
+	uint16_t port = dns_resolver_port ? htons(atoi(dns_resolver_port)) : 0;
 	char err[NB_DNS_ERRSIZE];
 
 	if ( dns_resolver_addr == IPAddr() )
@@ -428,12 +462,14 @@ void DNS_Mgr::InitSource()
 			{
 			struct sockaddr_in* sa = (struct sockaddr_in*)&ss;
 			sa->sin_family = AF_INET;
+			sa->sin_port = port;
 			dns_resolver_addr.CopyIPv4(&sa->sin_addr);
 			}
 		else
 			{
 			struct sockaddr_in6* sa = (struct sockaddr_in6*)&ss;
 			sa->sin6_family = AF_INET6;
+			sa->sin6_port = port;
 			dns_resolver_addr.CopyIPv6(&sa->sin6_addr);
 			}
 
@@ -464,6 +500,9 @@ void DNS_Mgr::InitPostScript()
 
 	dm_rec = internal_type("dns_mapping")->AsRecordType();
 
+	negative_ttl = uint32_t(opt_internal_double("dns_negative_ttl"));
+	max_cache_entries = opt_internal_unsigned("dns_cache_max_entries");
+
 	// Registering will call Init()
 	iosource_mgr->Register(this, true);
 
@@ -513,8 +552,10 @@ IntrusivePtr<TableVal> DNS_Mgr::LookupHost(const char* name)
 
 		if ( it != host_mappings.end() )
 			{
-			DNS_Mapping* d4 = it->second.first;
-			DNS_Mapping* d6 = it->second.second;
+			DNS_Mapping* d4 = it->second.value.first;
+			DNS_Mapping* d6 = it->second.value.second;
+
+			host_mappings.Touch(it);
 
 			if ( (d4 && d4->Failed()) || (d6 && d6->Failed()) )
 				{
@@ -564,7 +605,9 @@ IntrusivePtr<Val> DNS_Mgr::LookupAddr(const IPAddr& addr)
 
 		if ( it != addr_mappings.end() )
 			{
-			DNS_Mapping* d = it->second;
+			DNS_Mapping* d = it->second.value;
+			addr_mappings.Touch(it);
+
 			if ( d->Valid() )
 				return d->Host();
 			else
@@ -749,7 +792,8 @@ IntrusivePtr<Val> DNS_Mgr::BuildMappingVal(DNS_Mapping* dm)
 void DNS_Mgr::AddResult(DNS_Mgr_Request* dr, struct nb_dns_result* r)
 	{
 	struct hostent* h = (r && r->host_errno == 0) ? r->hostent : nullptr;
-	u_int32_t ttl = (r && r->host_errno == 0) ? r->ttl : 0;
+	// Failures are remembered for the negative TTL.
+	u_int32_t ttl = (r && r->host_errno == 0) ? r->ttl : negative_ttl;
 
 	DNS_Mapping* new_dm;
 	DNS_Mapping* prev_dm;
@@ -768,8 +812,8 @@ void DNS_Mgr::AddResult(DNS_Mgr_Request* dr, struct nb_dns_result* r)
 				text_mappings[dr->ReqHost()] = new_dm;
 			else
 				{
-				prev_dm = it->second;
-				it->second = new_dm;
+				prev_dm = it->second.value;
+				it->second.value = new_dm;
 				}
 
 			if ( new_dm->Failed() && prev_dm && prev_dm->Valid() )
@@ -780,26 +824,30 @@ void DNS_Mgr::AddResult(DNS_Mgr_Request* dr, struct nb_dns_result* r)
 			}
 		else
 			{
+			// Pick the slot by the request's family: a failed
+			// mapping doesn't know its type.
+			bool is_v4 = dr->Family() == AF_INET;
+
 			HostMap::iterator it = host_mappings.find(dr->ReqHost());
 			if ( it == host_mappings.end() )
 				{
 				host_mappings[dr->ReqHost()].first =
-					new_dm->Type() == AF_INET ? new_dm : nullptr;
+					is_v4 ? new_dm : nullptr;
 
 				host_mappings[dr->ReqHost()].second =
-					new_dm->Type() == AF_INET ? nullptr : new_dm;
+					is_v4 ? nullptr : new_dm;
 				}
 			else
 				{
-				if ( new_dm->Type() == AF_INET )
+				if ( is_v4 )
 					{
-					prev_dm = it->second.first;
-					it->second.first = new_dm;
+					prev_dm = it->second.value.first;
+					it->second.value.first = new_dm;
 					}
 				else
 					{
-					prev_dm = it->second.second;
-					it->second.second = new_dm;
+					prev_dm = it->second.value.second;
+					it->second.value.second = new_dm;
 					}
 				}
 
@@ -807,7 +855,7 @@ void DNS_Mgr::AddResult(DNS_Mgr_Request* dr, struct nb_dns_result* r)
 				{
 				// Put previous, valid entry back - CompareMappings
 				// will generate a corresponding warning.
-				if ( prev_dm->Type() == AF_INET )
+				if ( is_v4 )
 					host_mappings[dr->ReqHost()].first = prev_dm;
 				else
 					host_mappings[dr->ReqHost()].second = prev_dm;
@@ -820,7 +868,7 @@ void DNS_Mgr::AddResult(DNS_Mgr_Request* dr, struct nb_dns_result* r)
 		{
 		new_dm = new DNS_Mapping(dr->ReqAddr(), h, ttl);
 		AddrMap::iterator it = addr_mappings.find(dr->ReqAddr());
-		prev_dm = (it == addr_mappings.end()) ? 0 : it->second;
+		prev_dm = (it == addr_mappings.end()) ? 0 : it->second.value;
 		addr_mappings[dr->ReqAddr()] = new_dm;
 
 		if ( new_dm->Failed() && prev_dm && prev_dm->Valid() )
@@ -837,6 +885,8 @@ void DNS_Mgr::AddResult(DNS_Mgr_Request* dr, struct nb_dns_result* r)
 		delete new_dm;
 	else
 		delete prev_dm;
+
+	TrimCaches();
 	}
 
 void DNS_Mgr::CompareMappings(DNS_Mapping* prev_dm, DNS_Mapping* new_dm)
@@ -950,14 +1000,15 @@ void DNS_Mgr::LoadCache(FILE* f)
 
 	delete m;
 	fclose(f);
+	TrimCaches();
 	}
 
 void DNS_Mgr::Save(FILE* f, const AddrMap& m)
 	{
 	for ( AddrMap::const_iterator it = m.begin(); it != m.end(); ++it )
 		{
-		if ( it->second )
-			it->second->Save(f);
+		if ( it->second.value )
+			it->second.value->Save(f);
 		}
 	}
 
@@ -967,22 +1018,22 @@ void DNS_Mgr::Save(FILE* f, const HostMap& m)
 
 	for ( it = m.begin(); it != m.end(); ++it )
 		{
-		if ( it->second.first )
-			it->second.first->Save(f);
+		if ( it->second.value.first )
+			it->second.value.first->Save(f);
 
-		if ( it->second.second )
-			it->second.second->Save(f);
+		if ( it->second.value.second )
+			it->second.value.second->Save(f);
 		}
 	}
 
-const char* DNS_Mgr::LookupAddrInCache(const IPAddr& addr)
+DNS_Mapping* DNS_Mgr::CachedAddr(const IPAddr& addr)
 	{
 	AddrMap::iterator it = addr_mappings.find(addr);
 
 	if ( it == addr_mappings.end() )
 		return nullptr;
 
-	DNS_Mapping* d = it->second;
+	DNS_Mapping* d = it->second.value;
 
 	if ( d->Expired() )
 		{
@@ -991,47 +1042,44 @@ const char* DNS_Mgr::LookupAddrInCache(const IPAddr& addr)
 		return nullptr;
 		}
 
-	// The escapes in the following strings are to avoid having it
-	// interpreted as a trigraph sequence.
-	return d->names ? d->names[0] : "<\?\?\?>";
+	addr_mappings.Touch(it);
+	return d;
 	}
 
-IntrusivePtr<TableVal> DNS_Mgr::LookupNameInCache(const string& name)
+bool DNS_Mgr::CachedName(const string& name, DNS_Mapping** d4, DNS_Mapping** d6)
 	{
 	HostMap::iterator it = host_mappings.find(name);
+
 	if ( it == host_mappings.end() )
-		{
-		it = host_mappings.begin();
-		return nullptr;
-		}
+		return false;
 
-	DNS_Mapping* d4 = it->second.first;
-	DNS_Mapping* d6 = it->second.second;
+	*d4 = it->second.value.first;
+	*d6 = it->second.value.second;
 
-	if ( ! d4 || ! d4->names || ! d6 || ! d6->names )
-		return nullptr;
+	if ( ! *d4 || ! *d6 )
+		// Still waiting for one of the two answers.
+		return false;
 
-	if ( d4->Expired() || d6->Expired() )
+	if ( (*d4)->Expired() || (*d6)->Expired() )
 		{
 		host_mappings.erase(it);
-		delete d4;
-		delete d6;
-		return nullptr;
+		delete *d4;
+		delete *d6;
+		return false;
 		}
 
-	auto tv4 = d4->AddrsSet();
-	auto tv6 = d6->AddrsSet();
-	tv4->AddTo(tv6.get(), false);
-	return tv6;
+	host_mappings.Touch(it);
+	return true;
 	}
 
-const char* DNS_Mgr::LookupTextInCache(const string& name)
+DNS_Mapping* DNS_Mgr::CachedText(const string& name)
 	{
 	TextMap::iterator it = text_mappings.find(name);
+
 	if ( it == text_mappings.end() )
 		return nullptr;
 
-	DNS_Mapping* d = it->second;
+	DNS_Mapping* d = it->second.value;
 
 	if ( d->Expired() )
 		{
@@ -1040,9 +1088,73 @@ const char* DNS_Mgr::LookupTextInCache(const string& name)
 		return nullptr;
 		}
 
-	// The escapes in the following strings are to avoid having it
-	// interpreted as a trigraph sequence.
-	return d->names ? d->names[0] : "<\?\?\?>";
+	text_mappings.Touch(it);
+	return d;
+	}
+
+template <typename Cache>
+static unsigned long trim_cache(Cache* c, size_t max_entries)
+	{
+	unsigned long n = 0;
+
+	while ( c->size() > max_entries )
+		{
+		auto it = c->Oldest();
+		delete_mappings(it->second.value);
+		c->erase(it);
+		++n;
+		}
+
+	return n;
+	}
+
+void DNS_Mgr::TrimCaches()
+	{
+	if ( max_cache_entries == 0 )
+		return;
+
+	evicted += trim_cache(&host_mappings, max_cache_entries);
+	evicted += trim_cache(&addr_mappings, max_cache_entries);
+	evicted += trim_cache(&text_mappings, max_cache_entries);
+	}
+
+const char* DNS_Mgr::LookupAddrInCache(const IPAddr& addr)
+	{
+	DNS_Mapping* d = CachedAddr(addr);
+
+	if ( ! d || d->Failed() )
+		return nullptr;
+
+	return mapping_name(d);
+	}
+
+static IntrusivePtr<TableVal> merged_addrs(DNS_Mapping* d4, DNS_Mapping* d6)
+	{
+	auto tv4 = d4->AddrsSet();
+	auto tv6 = d6->AddrsSet();
+	tv4->AddTo(tv6.get(), false);
+	return tv6;
+	}
+
+IntrusivePtr<TableVal> DNS_Mgr::LookupNameInCache(const string& name)
+	{
+	DNS_Mapping* d4;
+	DNS_Mapping* d6;
+
+	if ( ! CachedName(name, &d4, &d6) || d4->Failed() || d6->Failed() )
+		return nullptr;
+
+	return merged_addrs(d4, d6);
+	}
+
+const char* DNS_Mgr::LookupTextInCache(const string& name)
+	{
+	DNS_Mapping* d = CachedText(name);
+
+	if ( ! d || d->Failed() )
+		return nullptr;
+
+	return mapping_name(d);
 	}
 
 static void resolve_lookup_cb(DNS_Mgr::LookupCallback* callback,
@@ -1059,6 +1171,12 @@ static void resolve_lookup_cb(DNS_Mgr::LookupCallback* callback,
 	delete callback;
 	}
 
+static void timeout_lookup_cb(DNS_Mgr::LookupCallback* callback)
+	{
+	callback->Timeout();
+	delete callback;
+	}
+
 void DNS_Mgr::AsyncLookupAddr(const IPAddr& host, LookupCallback* callback)
 	{
 	InitSource();
@@ -1070,19 +1188,31 @@ void DNS_Mgr::AsyncLookupAddr(const IPAddr& host, LookupCallback* callback)
 		}
 
 	// Do we already know the answer?
-	const char* name = LookupAddrInCache(host);
-	if ( name )
+	DNS_Mapping* d = CachedAddr(host);
+
+	if ( d )
 		{
-		resolve_lookup_cb(callback, name);
+		++cache_hits;
+
+		if ( d->Valid() )
+			resolve_lookup_cb(callback, mapping_name(d));
+		else
+			timeout_lookup_cb(callback);
+
 		return;
 		}
 
+	++cache_misses;
+
 	AsyncRequest* req = nullptr;
 
 	// Have we already a request waiting for this host?
 	AsyncRequestAddrMap::iterator i = asyncs_addrs.find(host);
 	if ( i != asyncs_addrs.end() )
+		{
 		req = i->second;
+		++coalesced;
+		}
 	else
 		{
 		// A new one.
@@ -1108,19 +1238,32 @@ void DNS_Mgr::AsyncLookupName(const string& name, LookupCallback* callback)
 		}
 
 	// Do we already know the answer?
-	auto addrs = LookupNameInCache(name);
-	if ( addrs )
+	DNS_Mapping* d4;
+	DNS_Mapping* d6;
+
+	if ( CachedName(name, &d4, &d6) )
 		{
-		resolve_lookup_cb(callback, std::move(addrs));
+		++cache_hits;
+
+		if ( d4->Valid() && d6->Valid() )
+			resolve_lookup_cb(callback, merged_addrs(d4, d6));
+		else
+			timeout_lookup_cb(callback);
+
 		return;
 		}
 
+	++cache_misses;
+
 	AsyncRequest* req = nullptr;
 
 	// Have we already a request waiting for this host?
 	AsyncRequestNameMap::iterator i = asyncs_names.find(name);
 	if ( i != asyncs_names.end() )
+		{
 		req = i->second;
+		++coalesced;
+		}
 	else
 		{
 		// A new one.
@@ -1146,20 +1289,31 @@ void DNS_Mgr::AsyncLookupNameText(const string& name, LookupCallback* callback)
 		}
 
 	// Do we already know the answer?
-	const char* txt = LookupTextInCache(name);
+	DNS_Mapping* d = CachedText(name);
 
-	if ( txt )
+	if ( d )
 		{
-		resolve_lookup_cb(callback, txt);
+		++cache_hits;
+
+		if ( d->Valid() )
+			resolve_lookup_cb(callback, mapping_name(d));
+		else
+			timeout_lookup_cb(callback);
+
 		return;
 		}
 
+	++cache_misses;
+
 	AsyncRequest* req = nullptr;
 
 	// Have we already a request waiting for this host?
 	AsyncRequestTextMap::iterator i = asyncs_texts.find(name);
 	if ( i != asyncs_texts.end() )
+		{
 		req = i->second;
+		++coalesced;
+		}
 	else
 		{
 		// A new one.
@@ -1235,14 +1389,15 @@ void DNS_Mgr::CheckAsyncAddrRequest(const IPAddr& addr, bool timeout)
 
 	if ( i != asyncs_addrs.end() )
 		{
-		const char* name = LookupAddrInCache(addr);
-		if ( name )
+		DNS_Mapping* d = CachedAddr(addr);
+
+		if ( d && d->Valid() )
 			{
 			++successful;
-			i->second->Resolved(name);
+			i->second->Resolved(mapping_name(d));
 			}
 
-		else if ( timeout )
+		else if ( timeout || d )
 			{
 			++failed;
 			i->second->Timeout();
@@ -1267,16 +1422,16 @@ void DNS_Mgr::CheckAsyncTextRequest(const char* host, bool timeout)
 	AsyncRequestTextMap::iterator i = asyncs_texts.find(host);
 	if ( i != asyncs_texts.end() )
 		{
-		const char* name = LookupTextInCache(host);
-		if ( name )
+		DNS_Mapping* d = CachedText(host);
+
+		if ( d && d->Valid() )
 			{
 			++successful;
-			i->second->Resolved(name);
+			i->second->Resolved(mapping_name(d));
 			}
 
-		else if ( timeout )
+		else if ( timeout || d )
 			{
-			AsyncRequestTextMap::iterator it = asyncs_texts.begin();
 			++failed;
 			i->second->Timeout();
 			}
@@ -1300,15 +1455,17 @@ void DNS_Mgr::CheckAsyncHostRequest(const char* host, bool timeout)
 
 	if ( i != asyncs_names.end() )
 		{
-		auto addrs = LookupNameInCache(host);
+		DNS_Mapping* d4;
+		DNS_Mapping* d6;
+		bool cached = CachedName(host, &d4, &d6);
 
-		if ( addrs )
+		if ( cached && d4->Valid() && d6->Valid() )
 			{
 			++successful;
-			i->second->Resolved(addrs.get());
+			i->second->Resolved(merged_addrs(d4, d6).get());
 			}
 
-		else if ( timeout )
+		else if ( timeout || cached )
 			{
 			++failed;
 			i->second->Timeout();
@@ -1331,16 +1488,13 @@ void DNS_Mgr::Flush()
 
 	HostMap::iterator it;
 	for ( it = host_mappings.begin(); it != host_mappings.end(); ++it )
-		{
-		delete it->second.first;
-		delete it->second.second;
-		}
+		delete_mappings(it->second.value);
 
 	for ( AddrMap::iterator it2 = addr_mappings.begin(); it2 != addr_mappings.end(); ++it2 )
-		delete it2->second;
+		delete_mappings(it2->second.value);
 
 	for ( TextMap::iterator it3 = text_mappings.begin(); it3 != text_mappings.end(); ++it3 )
-		delete it3->second;
+		delete_mappings(it3->second.value);
 
 	host_mappings.clear();
 	addr_mappings.clear();
@@ -1471,6 +1625,10 @@ void DNS_Mgr::GetStats(Stats* stats)
 	stats->cached_hosts = host_mappings.size();
 	stats->cached_addresses = addr_mappings.size();
 	stats->cached_texts = text_mappings.size();
+	stats->cache_hits = cache_hits;
+	stats->cache_misses = cache_misses;
+	stats->coalesced = coalesced;
+	stats->evicted = evicted;
 	}
 
 void DNS_Mgr::Terminate()
@@ -2,9 +2,11 @@
 
 #pragma once
 
+#include <deque>
 #include <list>
-#include <map>
 #include <queue>
+#include <string>
+#include <unordered_map>
 #include <utility>
 
 #include "List.h"
@@ -86,6 +88,10 @@ public:
 		unsigned long cached_hosts;
 		unsigned long cached_addresses;
 		unsigned long cached_texts;
+		unsigned long cache_hits;	// Async lookups answered from the cache.
+		unsigned long cache_misses;
+		unsigned long coalesced;	// Async lookups joining a pending request.
+		unsigned long evicted;	// Cache entries dropped due to the size limit.
 	};
 
 	void GetStats(Stats* stats);
@@ -108,13 +114,96 @@ protected:
 	IntrusivePtr<ListVal> AddrListDelta(ListVal* al1, ListVal* al2);
 	void DumpAddrList(FILE* f, ListVal* al);
 
-	typedef std::map<std::string, std::pair<DNS_Mapping*, DNS_Mapping*> > HostMap;
-	typedef std::map<IPAddr, DNS_Mapping*> AddrMap;
-	typedef std::map<std::string, DNS_Mapping*> TextMap;
+	// Hashes addresses with the process' hash key, as they are often
+	// derived from traffic.
+	struct AddrHash {
+		size_t operator()(const IPAddr& addr) const;
+	};
+
+	// A hash map of DNS mappings that keeps track of the order in which
+	// its entries were used, so that the least recently used ones can be
+	// evicted once it grows too large.
+	template <typename Key, typename Value, typename Hash = std::hash<Key>>
+	class MappingCache {
+	public:
+		struct Entry {
+			Value value;
+			typename std::list<const Key*>::iterator lru;
+		};
+
+		typedef std::unordered_map<Key, Entry, Hash> Map;
+		typedef typename Map::iterator iterator;
+		typedef typename Map::const_iterator const_iterator;
+
+		iterator begin()	{ return map.begin(); }
+		iterator end()	{ return map.end(); }
+		const_iterator begin() const	{ return map.begin(); }
+		const_iterator end() const	{ return map.end(); }
+		size_t size() const	{ return map.size(); }
+
+		iterator find(const Key& k)	{ return map.find(k); }
+
+		// Returns the value for a key, inserting an empty one if
+		// there's none yet, and marks the entry as most recently used.
+		Value& operator[](const Key& k)
+			{
+			auto it = map.find(k);
+
+			if ( it == map.end() )
+				{
+				it = map.emplace(k, Entry{Value(), lru.end()}).first;
+				lru.push_front(&it->first);
+				it->second.lru = lru.begin();
+				}
+			else
+				Touch(it);
+
+			return it->second.value;
+			}
+
+		// Marks an entry as most recently used.
+		void Touch(iterator it)
+			{ lru.splice(lru.begin(), lru, it->second.lru); }
+
+		// Returns the least recently used entry, or end() if empty.
+		iterator Oldest()
+			{ return lru.empty() ? map.end() : map.find(*lru.back()); }
+
+		void erase(iterator it)
+			{
+			lru.erase(it->second.lru);
+			map.erase(it);
+			}
+
+		void clear()
+			{
+			lru.clear();
+			map.clear();
+			}
+
+	private:
+		Map map;
+		std::list<const Key*> lru;	// Most recently used first.
+	};
+
+	typedef MappingCache<std::string, std::pair<DNS_Mapping*, DNS_Mapping*> > HostMap;
+	typedef MappingCache<IPAddr, DNS_Mapping*, AddrHash> AddrMap;
+	typedef MappingCache<std::string, DNS_Mapping*> TextMap;
 	void LoadCache(FILE* f);
 	void Save(FILE* f, const AddrMap& m);
 	void Save(FILE* f, const HostMap& m);
 
+	// Return the cached mappings for a request, dropping them if they
+	// have expired.  Mappings of failed lookups are returned as well,
+	// until their negative TTL expires.
+	DNS_Mapping* CachedAddr(const IPAddr& addr);
+	DNS_Mapping* CachedText(const std::string& name);
+	bool CachedName(const std::string& name, DNS_Mapping** d4, DNS_Mapping** d6);
+
+	// Evicts the least recently used entries of caches that have grown
+	// beyond their size limit.
+	void TrimCaches();
+
 	// Selects on the fd to see if there is an answer available (timeout
 	// is secs). Returns 0 on timeout, -1 on EINTR or other error, and 1
 	// if answer is ready.
@@ -211,16 +300,16 @@ protected:
 
 	};
 
-	typedef std::map<IPAddr, AsyncRequest*> AsyncRequestAddrMap;
+	typedef std::unordered_map<IPAddr, AsyncRequest*, AddrHash> AsyncRequestAddrMap;
 	AsyncRequestAddrMap asyncs_addrs;
 
-	typedef std::map<std::string, AsyncRequest*> AsyncRequestNameMap;
+	typedef std::unordered_map<std::string, AsyncRequest*> AsyncRequestNameMap;
 	AsyncRequestNameMap asyncs_names;
 
-	typedef std::map<std::string, AsyncRequest*> AsyncRequestTextMap;
+	typedef std::unordered_map<std::string, AsyncRequest*> AsyncRequestTextMap;
 	AsyncRequestTextMap asyncs_texts;
 
-	typedef std::list<AsyncRequest*> QueuedList;
+	typedef std::deque<AsyncRequest*> QueuedList;
 	QueuedList asyncs_queued;
 
 	struct AsyncRequestCompare {
@@ -238,6 +327,15 @@ protected:
 	unsigned long num_requests;
 	unsigned long successful;
 	unsigned long failed;
+	unsigned long cache_hits;
+	unsigned long cache_misses;
+	unsigned long coalesced;
+	unsigned long evicted;
+
+	// How long failed lookups are remembered, and how many entries each
+	// cache may hold (0 for unlimited).
+	uint32_t negative_ttl;
+	size_t max_cache_entries;
 };
 
 extern DNS_Mgr* dns_mgr;
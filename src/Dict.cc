@@ -410,6 +410,8 @@ IterCookie* Dictionary::InitForIteration() const
 
 void Dictionary::StopIteration(IterCookie* cookie) const
 	{
+	// Robust cookies must not be updated anymore once they're gone.
+	const_cast<PList<IterCookie>*>(&cookies)->remove(cookie);
 	delete cookie;
 	}
 
@@ -17,6 +17,10 @@ EventMgr mgr;
 
 uint64_t num_events_queued = 0;
 uint64_t num_events_dispatched = 0;
+uint64_t num_events_filtered = 0;
+
+// Upper bound on the number of dispatched events kept around for reuse.
+static constexpr size_t max_free_events = 4096;
 
 Event::Event(EventHandlerPtr arg_handler, zeek::Args arg_args,
              SourceID arg_src, analyzer::ID arg_aid, BroObj* arg_obj)
@@ -31,6 +35,20 @@ Event::Event(EventHandlerPtr arg_handler, zeek::Args arg_args,
 		Ref(obj);
 	}
 
+void Event::Reset(EventHandlerPtr arg_handler, zeek::Args arg_args,
+                  SourceID arg_src, analyzer::ID arg_aid, BroObj* arg_obj)
+	{
+	handler = arg_handler;
+	args = std::move(arg_args);
+	src = arg_src;
+	aid = arg_aid;
+	obj = arg_obj;
+	next_event = nullptr;
+
+	if ( obj )
+		Ref(obj);
+	}
+
 void Event::Describe(ODesc* d) const
 	{
 	if ( d->IsReadable() )
@@ -65,8 +83,11 @@ void Event::Dispatch(bool no_remote)
 		}
 
 	if ( obj )
+		{
 		// obj->EventDone();
 		Unref(obj);
+		obj = nullptr;
+		}
 
 	if ( handler->ErrorHandler() )
 		reporter->EndErrorHandler();
@@ -90,6 +111,9 @@ EventMgr::~EventMgr()
 		head = n;
 		}
 
+	for ( auto e : free_events )
+		Unref(e);
+
 	Unref(src_val);
 	}
 
@@ -97,7 +121,7 @@ void EventMgr::QueueEventFast(const EventHandlerPtr &h, val_list vl,
                               SourceID src, analyzer::ID aid, TimerMgr* mgr,
                               BroObj* obj)
 	{
-	QueueEvent(new Event(h, zeek::val_list_to_args(vl), src, aid, obj));
+	QueueEvent(NewEvent(h, zeek::val_list_to_args(vl), src, aid, obj));
 	}
 
 void EventMgr::QueueEvent(const EventHandlerPtr &h, val_list vl,
@@ -124,7 +148,34 @@ void EventMgr::QueueEvent(const EventHandlerPtr &h, val_list* vl,
 void EventMgr::Enqueue(const EventHandlerPtr& h, zeek::Args vl,
                        SourceID src, analyzer::ID aid, BroObj* obj)
 	{
-	QueueEvent(new Event(h, std::move(vl), src, aid, obj));
+	QueueEvent(NewEvent(h, std::move(vl), src, aid, obj));
+	}
+
+Event* EventMgr::NewEvent(const EventHandlerPtr& h, zeek::Args vl,
+                          SourceID src, analyzer::ID aid, BroObj* obj)
+	{
+	if ( free_events.empty() )
+		return new Event(h, std::move(vl), src, aid, obj);
+
+	Event* e = free_events.back();
+	free_events.pop_back();
+	e->Reset(h, std::move(vl), src, aid, obj);
+	return e;
+	}
+
+void EventMgr::Recycle(Event* event)
+	{
+	// A plugin may have held on to the event.
+	if ( event->RefCnt() > 1 || free_events.size() >= max_free_events )
+		{
+		Unref(event);
+		return;
+		}
+
+	zeek::recycle_args(event->args);
+	event->handler = nullptr;
+	event->next_event = nullptr;
+	free_events.push_back(event);
 	}
 
 void EventMgr::QueueEvent(Event* event)
@@ -152,7 +203,7 @@ void EventMgr::Dispatch(Event* event, bool no_remote)
 	{
 	current_src = event->Source();
 	event->Dispatch(no_remote);
-	Unref(event);
+	Recycle(event);
 	}
 
 void EventMgr::Drain()
@@ -186,7 +237,7 @@ void EventMgr::Drain()
 			current_src = current->Source();
 			current_aid = current->Analyzer();
 			current->Dispatch();
-			Unref(current);
+			Recycle(current);
 
 			++num_events_dispatched;
 			current = next;
@@ -11,6 +11,7 @@
 
 #include <tuple>
 #include <type_traits>
+#include <vector>
 
 class EventMgr;
 
@@ -37,6 +38,10 @@ protected:
 	// EventMgr::Dispatch().
 	void Dispatch(bool no_remote = false);
 
+	// Used by EventMgr to reinitialize a recycled event.
+	void Reset(EventHandlerPtr handler, zeek::Args args, SourceID src,
+	           analyzer::ID aid, BroObj* obj);
+
 	EventHandlerPtr handler;
 	zeek::Args args;
 	SourceID src;
@@ -47,6 +52,7 @@ protected:
 
 extern uint64_t num_events_queued;
 extern uint64_t num_events_dispatched;
+extern uint64_t num_events_filtered;
 
 class EventMgr final : public BroObj, public iosource::IOSource {
 public:
@@ -110,7 +116,7 @@ public:
 	  std::is_convertible_v<
 	    std::tuple_element_t<0, std::tuple<Args...>>, IntrusivePtr<Val>>>
 	Enqueue(const EventHandlerPtr& h, Args&&... args)
-		{ return Enqueue(h, zeek::Args{std::forward<Args>(args)...}); }
+		{ return Enqueue(h, zeek::make_args(std::forward<Args>(args)...)); }
 
 	void Dispatch(Event* event, bool no_remote = false);
 
@@ -139,6 +145,15 @@ public:
 protected:
 	void QueueEvent(Event* event);
 
+	// Returns an event for the given arguments, reusing a dispatched one
+	// if possible.
+	Event* NewEvent(const EventHandlerPtr& h, zeek::Args vl, SourceID src,
+	                analyzer::ID aid, BroObj* obj);
+
+	// Disposes of a dispatched event, keeping it around for reuse if
+	// nobody else holds a reference to it.
+	void Recycle(Event* event);
+
 	Event* head;
 	Event* tail;
 	SourceID current_src;
@@ -146,6 +161,7 @@ protected:
 	RecordVal* src_val;
 	bool draining;
 	bro::Flare queue_flare;
+	std::vector<Event*> free_events;
 };
 
 extern EventMgr mgr;
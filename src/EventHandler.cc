@@ -60,12 +60,105 @@ void EventHandler::SetLocalHandler(Func* f)
 	local = f;
 	}
 
+EventHandler::ArgFilter* EventHandler::FindArgFilter(int arg)
+	{
+	for ( auto& f : arg_filters )
+		if ( f.arg == arg )
+			return &f;
+
+	return nullptr;
+	}
+
+const EventHandler::ArgFilter* EventHandler::FindArgFilter(int arg) const
+	{
+	for ( const auto& f : arg_filters )
+		if ( f.arg == arg )
+			return &f;
+
+	return nullptr;
+	}
+
+void EventHandler::SetArgFilter(int arg, std::unordered_set<std::string> values)
+	{
+	auto f = FindArgFilter(arg);
+
+	if ( ! f )
+		{
+		arg_filters.emplace_back();
+		f = &arg_filters.back();
+		f->arg = arg;
+		}
+
+	f->is_string = true;
+	f->strings = std::move(values);
+	f->counts.clear();
+	}
+
+void EventHandler::SetArgFilter(int arg, std::unordered_set<bro_uint_t> values)
+	{
+	auto f = FindArgFilter(arg);
+
+	if ( ! f )
+		{
+		arg_filters.emplace_back();
+		f = &arg_filters.back();
+		f->arg = arg;
+		}
+
+	f->is_string = false;
+	f->counts = std::move(values);
+	f->strings.clear();
+	}
+
+bool EventHandler::Accepts(int arg, const std::string& value) const
+	{
+	auto f = FindArgFilter(arg);
+	return ! f || f->strings.count(value);
+	}
+
+bool EventHandler::Accepts(int arg, bro_uint_t value) const
+	{
+	auto f = FindArgFilter(arg);
+	return ! f || f->counts.count(value);
+	}
+
+bool EventHandler::Accepts(const zeek::Args& vl) const
+	{
+	for ( const auto& f : arg_filters )
+		{
+		if ( f.arg >= int(vl.size()) || ! vl[f.arg] )
+			continue;
+
+		const Val* v = vl[f.arg].get();
+
+		if ( f.is_string )
+			{
+			const BroString* s = v->AsString();
+			std::string value(reinterpret_cast<const char*>(s->Bytes()), s->Len());
+
+			if ( ! f.strings.count(value) )
+				return false;
+			}
+
+		else if ( ! f.counts.count(v->AsCount()) )
+			return false;
+		}
+
+	return true;
+	}
+
 void EventHandler::Call(const zeek::Args& vl, bool no_remote)
 	{
 #ifdef PROFILE_BRO_FUNCTIONS
 	DEBUG_MSG("Event: %s\n", Name());
 #endif
 
+	if ( ! arg_filters.empty() && ! Accepts(vl) )
+		{
+		++num_events_filtered;
+		return;
+		}
+
 	if ( new_event )
 		NewEvent(vl);
 
@@ -113,8 +206,43 @@ void EventHandler::Call(const zeek::Args& vl, bool no_remote)
 		}
 
 	if ( local )
-		// No try/catch here; we pass exceptions upstream.
-		local->Call(vl);
+		{
+		if ( event_handler_timing )
+			TimedCall(vl);
+		else
+			// No try/catch here; we pass exceptions upstream.
+			local->Call(vl);
+		}
+	}
+
+void EventHandler::TimedCall(const zeek::Args& vl)
+	{
+	if ( budget < 0 )
+		{
+		budget = event_handler_budget;
+
+		if ( event_handler_budgets )
+			{
+			auto n = make_intrusive<StringVal>(name);
+
+			if ( auto b = event_handler_budgets->Lookup(n.get(), false) )
+				budget = b->AsInterval();
+			}
+		}
+
+	auto start = LatencyStats::Clock::now();
+
+	// Calls that throw aren't recorded; exceptions pass upstream.
+	local->Call(vl);
+
+	double secs = timing.AddSince(start);
+
+	if ( budget > 0 && secs > budget )
+		{
+		++budget_exceeded;
+		reporter->Weird("event_handler_budget_exceeded",
+		                fmt("%s took %.6f s", Name(), secs));
+		}
 	}
 
 void EventHandler::NewEvent(const zeek::Args& vl)
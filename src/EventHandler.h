@@ -3,10 +3,13 @@
 #pragma once
 
 #include "BroList.h"
+#include "LatencyStats.h"
 #include "ZeekArgs.h"
+#include "util.h"
 
 #include <unordered_set>
 #include <string>
+#include <vector>
 
 class Func;
 class FuncType;
@@ -52,9 +55,73 @@ public:
 	void SetGenerateAlways()	{ generate_always = true; }
 	bool GenerateAlways()	{ return generate_always; }
 
+	/**
+	 * Restricts raising the event to when one of its arguments has one
+	 * of the given values.  Filters for different arguments must all
+	 * pass; a new filter for the same argument replaces the old one.
+	 * @param arg the argument's offset in the event's full signature.
+	 * @param values the values to let through, for a string argument.
+	 */
+	void SetArgFilter(int arg, std::unordered_set<std::string> values);
+
+	/**
+	 * Same as above, for a count argument.
+	 */
+	void SetArgFilter(int arg, std::unordered_set<bro_uint_t> values);
+
+	/**
+	 * Removes all argument filters.
+	 */
+	void ClearArgFilters()	{ arg_filters.clear(); }
+
+	bool HasArgFilters() const	{ return ! arg_filters.empty(); }
+
+	/**
+	 * Checks a single argument against the event's argument filters.
+	 * Analyzers use this to skip building an event's arguments when the
+	 * event would get dropped anyway.  Arguments without a filter
+	 * always pass.
+	 * @param arg the argument's offset in the event's full signature.
+	 * @param value the argument's value.
+	 * @return true if the argument passes.
+	 */
+	bool Accepts(int arg, const std::string& value) const;
+	bool Accepts(int arg, bro_uint_t value) const;
+
+	/**
+	 * Checks a complete argument list against the event's argument
+	 * filters.
+	 */
+	bool Accepts(const zeek::Args& vl) const;
+
+	/**
+	 * @return the timing of the handler's calls.  Calls are only timed
+	 * while the script-level ``event_handler_timing`` option is set.
+	 */
+	const LatencyStats& Timing() const	{ return timing; }
+
+	/**
+	 * @return the number of timed calls that took longer than the
+	 * handler's budget.
+	 */
+	uint64_t BudgetExceeded() const	{ return budget_exceeded; }
+
 private:
 	void NewEvent(const zeek::Args& vl);	// Raise new_event() meta event.
 
+	// Calls the local handler, recording how long that takes.
+	void TimedCall(const zeek::Args& vl);
+
+	struct ArgFilter {
+		int arg;
+		bool is_string;
+		std::unordered_set<std::string> strings;
+		std::unordered_set<bro_uint_t> counts;
+	};
+
+	ArgFilter* FindArgFilter(int arg);
+	const ArgFilter* FindArgFilter(int arg) const;
+
 	const char* name;
 	Func* local;
 	FuncType* type;
@@ -64,6 +131,11 @@ private:
 	bool generate_always;
 
 	std::unordered_set<std::string> auto_publish;
+	std::vector<ArgFilter> arg_filters;
+
+	LatencyStats timing;
+	uint64_t budget_exceeded = 0;
+	double budget = -1;	// looked up on first timed call; 0 if none
 };
 
 // Encapsulates a ptr to an event handler to overload the boolean operator.
@@ -19,6 +19,7 @@
 #include "module_util.h"
 #include "DebugLogger.h"
 #include "Hash.h"
+#include "Reduce.h"
 
 #include "broker/Data.h"
 
@@ -88,6 +89,46 @@ IntrusivePtr<Expr> Expr::MakeLvalue()
 	return {NewRef{}, this};
 	}
 
+IntrusivePtr<Expr> Expr::Reduce(Reducer* /* r */)
+	{
+	return {NewRef{}, this};
+	}
+
+// Returns true if an expression with the given tag may be evaluated while
+// reducing it, once its operands are constants.  These are the ones that
+// neither have side effects nor depend on anything but their operands.
+static bool is_foldable_tag(BroExprTag t)
+	{
+	switch ( t ) {
+	case EXPR_NOT:
+	case EXPR_COMPLEMENT:
+	case EXPR_POSITIVE:
+	case EXPR_NEGATE:
+	case EXPR_ADD:
+	case EXPR_SUB:
+	case EXPR_TIMES:
+	case EXPR_DIVIDE:
+	case EXPR_MOD:
+	case EXPR_AND:
+	case EXPR_OR:
+	case EXPR_XOR:
+	case EXPR_AND_AND:
+	case EXPR_OR_OR:
+	case EXPR_LT:
+	case EXPR_LE:
+	case EXPR_EQ:
+	case EXPR_NE:
+	case EXPR_GE:
+	case EXPR_GT:
+	case EXPR_ARITH_COERCE:
+	case EXPR_SIZE:
+		return true;
+
+	default:
+		return false;
+	}
+	}
+
 void Expr::EvalIntoAggregate(const BroType* /* t */, Val* /* aggr */,
 				Frame* /* f */) const
 	{
@@ -281,6 +322,18 @@ bool NameExpr::IsPure() const
 	return id->IsConst();
 	}
 
+IntrusivePtr<Expr> NameExpr::Reduce(Reducer* r)
+	{
+	// Options may change at any time, so stick to constants.
+	if ( in_const_init || ! id->IsGlobal() || ! id->IsConst() ||
+	     id->IsOption() || ! id->HasVal() ||
+	     ! Reducer::IsFoldableType(id->ID_Val()->Type()) )
+		return {NewRef{}, this};
+
+	r->InlinedConst();
+	return r->Replace(this, {NewRef{}, id->ID_Val()});
+	}
+
 TraversalCode NameExpr::Traverse(TraversalCallback* cb) const
 	{
 	TraversalCode tc = cb->PreExpr(this);
@@ -382,6 +435,20 @@ bool UnaryExpr::IsPure() const
 	return op->IsPure();
 	}
 
+IntrusivePtr<Expr> UnaryExpr::Reduce(Reducer* r)
+	{
+	if ( IsError() || tag == EXPR_REF )
+		// The operand of a reference is an lvalue, so must stay.
+		return {NewRef{}, this};
+
+	op = op->Reduce(r);
+
+	if ( op->IsConst() && is_foldable_tag(tag) )
+		return r->TryFold(this);
+
+	return {NewRef{}, this};
+	}
+
 TraversalCode UnaryExpr::Traverse(TraversalCallback* cb) const
 	{
 	TraversalCode tc = cb->PreExpr(this);
@@ -496,6 +563,47 @@ bool BinaryExpr::IsPure() const
 	return op1->IsPure() && op2->IsPure();
 	}
 
+IntrusivePtr<Expr> BinaryExpr::Reduce(Reducer* r)
+	{
+	if ( IsError() )
+		return {NewRef{}, this};
+
+	// The left-hand side of an assignment must stay an lvalue.
+	if ( tag != EXPR_ASSIGN && tag != EXPR_INDEX_SLICE_ASSIGN &&
+	     tag != EXPR_ADD_TO && tag != EXPR_REMOVE_FROM )
+		op1 = op1->Reduce(r);
+
+	op2 = op2->Reduce(r);
+
+	if ( ! is_foldable_tag(tag) )
+		return {NewRef{}, this};
+
+	if ( BothConst() )
+		{
+		// Leave errors to run-time, and to code that actually
+		// gets executed.
+		if ( (tag == EXPR_DIVIDE || tag == EXPR_MOD) &&
+		     (op2->IsZero() || op1->Type()->Tag() == TYPE_ADDR) )
+			return {NewRef{}, this};
+
+		return r->TryFold(this);
+		}
+
+	if ( (tag == EXPR_AND_AND || tag == EXPR_OR_OR) &&
+	     type->Tag() == TYPE_BOOL && op1->IsConst() )
+		{
+		r->RemovedBranch();
+
+		// "T || x" and "F && x" don't evaluate x.
+		if ( op1->ExprVal()->AsBool() == (tag == EXPR_OR_OR) )
+			return op1;
+
+		return op2;
+		}
+
+	return {NewRef{}, this};
+	}
+
 TraversalCode BinaryExpr::Traverse(TraversalCallback* cb) const
 	{
 	TraversalCode tc = cb->PreExpr(this);
@@ -1964,6 +2072,27 @@ bool CondExpr::IsPure() const
 	return op1->IsPure() && op2->IsPure() && op3->IsPure();
 	}
 
+IntrusivePtr<Expr> CondExpr::Reduce(Reducer* r)
+	{
+	if ( IsError() )
+		return {NewRef{}, this};
+
+	op1 = op1->Reduce(r);
+	op2 = op2->Reduce(r);
+	op3 = op3->Reduce(r);
+
+	if ( ! op1->IsConst() || is_vector(op1.get()) )
+		return {NewRef{}, this};
+
+	const auto& branch = op1->ExprVal()->IsZero() ? op3 : op2;
+
+	if ( ! same_type(branch->Type(), Type()) )
+		return {NewRef{}, this};
+
+	r->RemovedBranch();
+	return branch;
+	}
+
 TraversalCode CondExpr::Traverse(TraversalCallback* cb) const
 	{
 	TraversalCode tc = cb->PreExpr(this);
@@ -4163,6 +4292,37 @@ bool CallExpr::IsPure() const
 	return pure;
 	}
 
+IntrusivePtr<Expr> CallExpr::Reduce(Reducer* r)
+	{
+	if ( IsError() )
+		return {NewRef{}, this};
+
+	args->Reduce(r);
+
+	if ( func->Tag() != EXPR_NAME )
+		return {NewRef{}, this};
+
+	ID* id = func->AsNameExpr()->Id();
+
+	if ( ! id->IsGlobal() || ! id->IsConst() || ! id->HasVal() ||
+	     id->Type()->Tag() != TYPE_FUNC )
+		return {NewRef{}, this};
+
+	// Dropping the call also drops evaluating the arguments, which
+	// is only fine without side effects.
+	for ( const auto& arg : args->Exprs() )
+		if ( arg->Tag() != EXPR_NAME && ! arg->IsPure() )
+			return {NewRef{}, this};
+
+	Val* result = r->ConstantResult(id->ID_Val()->AsFunc());
+
+	if ( ! result || ! same_type(result->Type(), Type()) )
+		return {NewRef{}, this};
+
+	r->InlinedCall();
+	return r->Replace(this, {NewRef{}, result});
+	}
+
 IntrusivePtr<Val> CallExpr::Eval(Frame* f) const
 	{
 	if ( IsError() )
@@ -4394,6 +4554,14 @@ EventExpr::EventExpr(const char* arg_name, IntrusivePtr<ListExpr> arg_args)
 		}
 	}
 
+IntrusivePtr<Expr> EventExpr::Reduce(Reducer* r)
+	{
+	if ( ! IsError() )
+		args->Reduce(r);
+
+	return {NewRef{}, this};
+	}
+
 IntrusivePtr<Val> EventExpr::Eval(Frame* f) const
 	{
 	if ( IsError() )
@@ -4464,6 +4632,23 @@ bool ListExpr::IsPure() const
 	return true;
 	}
 
+IntrusivePtr<Expr> ListExpr::Reduce(Reducer* r)
+	{
+	for ( int i = 0; i < exprs.length(); ++i )
+		{
+		Expr* e = exprs[i];
+		auto reduced = e->Reduce(r);
+
+		if ( reduced.get() != e )
+			{
+			exprs.replace(i, reduced.release());
+			Unref(e);
+			}
+		}
+
+	return {NewRef{}, this};
+	}
+
 IntrusivePtr<Val> ListExpr::Eval(Frame* f) const
 	{
 	auto v = make_intrusive<ListVal>(TYPE_ANY);
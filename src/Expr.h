@@ -69,6 +69,7 @@ class IndexExpr;
 class AssignExpr;
 class CallExpr;
 class EventExpr;
+class Reducer;
 
 struct function_ingredients;
 
@@ -128,6 +129,12 @@ public:
 	// if it's not a constant.
 	inline Val* ExprVal() const;
 
+	// Returns an equivalent expression that's cheaper to evaluate,
+	// e.g. a constant if the expression only depends on constants.
+	// May replace the expression's operands with reduced versions.
+	// The default leaves the expression as it is.
+	virtual IntrusivePtr<Expr> Reduce(Reducer* r);
+
 	// True if the expression is a constant zero, false otherwise.
 	bool IsZero() const;
 
@@ -241,6 +248,8 @@ public:
 	IntrusivePtr<Expr> MakeLvalue() override;
 	bool IsPure() const override;
 
+	IntrusivePtr<Expr> Reduce(Reducer* r) override;
+
 	TraversalCode Traverse(TraversalCallback* cb) const override;
 
 protected:
@@ -276,6 +285,8 @@ public:
 
 	bool IsPure() const override;
 
+	IntrusivePtr<Expr> Reduce(Reducer* r) override;
+
 	TraversalCode Traverse(TraversalCallback* cb) const override;
 
 protected:
@@ -301,6 +312,8 @@ public:
 	// vectors correctly as necessary.
 	IntrusivePtr<Val> Eval(Frame* f) const override;
 
+	IntrusivePtr<Expr> Reduce(Reducer* r) override;
+
 	TraversalCode Traverse(TraversalCallback* cb) const override;
 
 protected:
@@ -488,6 +501,8 @@ public:
 	IntrusivePtr<Val> Eval(Frame* f) const override;
 	bool IsPure() const override;
 
+	IntrusivePtr<Expr> Reduce(Reducer* r) override;
+
 	TraversalCode Traverse(TraversalCallback* cb) const override;
 
 protected:
@@ -791,6 +806,8 @@ public:
 
 	IntrusivePtr<Val> Eval(Frame* f) const override;
 
+	IntrusivePtr<Expr> Reduce(Reducer* r) override;
+
 	TraversalCode Traverse(TraversalCallback* cb) const override;
 
 protected:
@@ -836,6 +853,8 @@ public:
 
 	IntrusivePtr<Val> Eval(Frame* f) const override;
 
+	IntrusivePtr<Expr> Reduce(Reducer* r) override;
+
 	TraversalCode Traverse(TraversalCallback* cb) const override;
 
 protected:
@@ -867,6 +886,8 @@ public:
 	IntrusivePtr<Expr> MakeLvalue() override;
 	void Assign(Frame* f, IntrusivePtr<Val> v) override;
 
+	IntrusivePtr<Expr> Reduce(Reducer* r) override;
+
 	TraversalCode Traverse(TraversalCallback* cb) const override;
 
 protected:
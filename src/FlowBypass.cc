@@ -0,0 +1,194 @@
+// See the file "COPYING" in the main distribution directory for copyright.
+
+#include "zeek-config.h"
+
+#include "FlowBypass.h"
+
+#include <netinet/tcp.h>
+
+#include "Conn.h"
+#include "Hash.h"
+#include "IP.h"
+#include "Var.h"
+
+FlowBypass::FlowBypass()
+	{
+	timeout = opt_internal_double("flow_bypass_timeout");
+	max_flows = opt_internal_unsigned("flow_bypass_max_flows");
+	}
+
+void FlowBypass::GetStats(Stats* s) const
+	{
+	s->num_flows = num_flows;
+	s->cumulative_flows = cumulative_flows;
+	s->packets = packets;
+	s->bytes = bytes;
+	}
+
+size_t FlowBypass::Probe(const ConnIDKey& key, uint8_t proto) const
+	{
+	size_t mask = flows.size() - 1;
+	size_t slot = KeyedHash::Hash64(&key, sizeof(key)) & mask;
+	size_t free_slot = flows.size();
+
+	while ( true )
+		{
+		const Flow& f = flows[slot];
+
+		if ( f.state == EMPTY )
+			return free_slot < flows.size() ? free_slot : slot;
+
+		if ( f.state == DELETED )
+			{
+			if ( free_slot == flows.size() )
+				free_slot = slot;
+			}
+
+		else if ( f.proto == proto && f.key == key )
+			return slot;
+
+		slot = (slot + 1) & mask;
+		}
+	}
+
+void FlowBypass::Delete(size_t slot)
+	{
+	flows[slot].state = DELETED;
+	--num_flows;
+	++num_deleted;
+	}
+
+void FlowBypass::Rehash(double t, size_t capacity)
+	{
+	std::vector<Flow> old(capacity);
+	old.swap(flows);
+	num_flows = num_deleted = 0;
+
+	for ( const auto& f : old )
+		{
+		if ( f.state != USED || Expired(f, t) )
+			continue;
+
+		flows[Probe(f.key, f.proto)] = f;
+		++num_flows;
+		}
+	}
+
+bool FlowBypass::Add(const ConnIDKey& key, TransportProto proto, double t)
+	{
+	if ( flows.empty() )
+		flows.resize(1024);
+
+	// Keep at least a quarter of the slots empty so that probes for
+	// unknown flows, i.e. most packets, stay short.
+	if ( (num_flows + num_deleted + 1) * 4 > flows.size() * 3 )
+		{
+		size_t capacity = flows.size();
+
+		if ( (num_flows + 1) * 2 > capacity )
+			capacity *= 2;
+
+		Rehash(t, capacity);
+		}
+
+	size_t slot = Probe(key, proto);
+
+	if ( flows[slot].state != USED && max_flows && num_flows >= max_flows )
+		{
+		// Make room by dropping expired flows, if there are any.  That
+		// takes a pass over the whole table, so don't try that more
+		// than once a second.
+		if ( timeout <= 0 || t < last_purge + 1.0 )
+			return false;
+
+		last_purge = t;
+		Rehash(t, flows.size());
+
+		if ( num_flows >= max_flows )
+			return false;
+
+		slot = Probe(key, proto);
+		}
+
+	Flow& f = flows[slot];
+
+	if ( f.state != USED )
+		{
+
+		if ( f.state == DELETED )
+			--num_deleted;
+
+		f.key = key;
+		f.proto = proto;
+		f.state = USED;
+		++num_flows;
+		++cumulative_flows;
+		}
+
+	f.last_seen = t;
+	return true;
+	}
+
+bool FlowBypass::Match(double t, const IP_Hdr* ip, uint32_t len, uint32_t caplen)
+	{
+	int proto = ip->NextProto();
+	uint8_t transport;
+
+	if ( proto == IPPROTO_TCP )
+		transport = TRANSPORT_TCP;
+	else if ( proto == IPPROTO_UDP )
+		transport = TRANSPORT_UDP;
+	else
+		return false;
+
+	// Non-first fragments carry no ports.  They are rare enough to take
+	// the regular path, which then ignores them for bypassed connections.
+	if ( ip->IsFragment() )
+		return false;
+
+	uint32_t hdr_len = ip->HdrLen();
+
+	if ( caplen < hdr_len + 4 )
+		return false;
+
+	// TCP and UDP both start with the ports.
+	const u_char* data = ip->Payload();
+
+	ConnID id;
+	id.src_addr = ip->SrcAddr();
+	id.dst_addr = ip->DstAddr();
+	id.src_port = *reinterpret_cast<const uint16_t*>(data);
+	id.dst_port = *reinterpret_cast<const uint16_t*>(data + 2);
+	id.is_one_way = false;
+
+	ConnIDKey key = BuildConnIDKey(id);
+	size_t slot = Probe(key, transport);
+	Flow& f = flows[slot];
+
+	if ( f.state != USED )
+		return false;
+
+	if ( Expired(f, t) )
+		{
+		Delete(slot);
+		return false;
+		}
+
+	if ( transport == TRANSPORT_TCP && caplen >= hdr_len + 14 )
+		{
+		// An initial SYN means the tuple got reused for a new
+		// connection, which needs to be looked at again.
+		uint8_t flags = data[13];
+
+		if ( (flags & (TH_SYN | TH_ACK)) == TH_SYN )
+			{
+			Delete(slot);
+			return false;
+			}
+		}
+
+	f.last_seen = t;
+	++packets;
+	bytes += len;
+	return true;
+	}
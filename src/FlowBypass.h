@@ -0,0 +1,103 @@
+// See the file "COPYING" in the main distribution directory for copyright.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "IPAddr.h"
+#include "net_util.h"
+
+class IP_Hdr;
+
+/**
+ * Tracks TCP and UDP flows whose remaining packets Zeek doesn't need to look
+ * at anymore.  NetSessions consults this before doing anything else with a
+ * packet, so a bypassed flow's packets only cost computing the flow's key and
+ * a single probe into an open-addressing hash table, instead of a connection
+ * lookup and the trip through the analyzer tree.
+ *
+ * Flows are forgotten once they have been idle for a while, or when a TCP SYN
+ * starts a new connection with the same tuple.
+ */
+class FlowBypass {
+public:
+	/**
+	 * Statistics about bypassed flows.
+	 */
+	struct Stats {
+		uint64_t num_flows;	//! Number of flows currently bypassed.
+		uint64_t cumulative_flows;	//! Number of flows bypassed so far.
+		uint64_t packets;	//! Number of packets skipped.
+		uint64_t bytes;	//! Number of IP bytes skipped.
+	};
+
+	/**
+	 * Constructor.  Reads its configuration from the script-level
+	 * ``flow_bypass_timeout`` and ``flow_bypass_max_flows`` options.
+	 */
+	FlowBypass();
+
+	/**
+	 * Adds a flow to bypass.
+	 * @param key the flow's canonical connection key.
+	 * @param proto the flow's transport protocol, which must be TCP or UDP.
+	 * @param t the current time.
+	 * @return false if the maximum number of bypassed flows is reached.
+	 */
+	bool Add(const ConnIDKey& key, TransportProto proto, double t);
+
+	/**
+	 * Checks whether a packet belongs to a bypassed flow, and if so counts
+	 * it.
+	 * @param t the packet's timestamp.
+	 * @param ip the packet's IP header.
+	 * @param len the packet's IP length.
+	 * @param caplen the number of captured bytes, starting at the IP header.
+	 * @return true if the packet should be skipped.
+	 */
+	bool NextPacket(double t, const IP_Hdr* ip, uint32_t len, uint32_t caplen)
+		{ return num_flows && Match(t, ip, len, caplen); }
+
+	/**
+	 * Fills in the current statistics.
+	 */
+	void GetStats(Stats* s) const;
+
+private:
+	enum SlotState : uint8_t { EMPTY, USED, DELETED };
+
+	struct Flow {
+		ConnIDKey key;
+		uint8_t proto;
+		SlotState state;
+		double last_seen;
+	};
+
+	bool Match(double t, const IP_Hdr* ip, uint32_t len, uint32_t caplen);
+
+	// Returns the slot of the given flow, or of the first free slot if
+	// it's unknown.
+	size_t Probe(const ConnIDKey& key, uint8_t proto) const;
+
+	void Delete(size_t slot);
+
+	// Rebuilds the table with the given capacity, dropping deleted
+	// slots and expired flows along the way.
+	void Rehash(double t, size_t capacity);
+
+	bool Expired(const Flow& f, double t) const
+		{ return timeout > 0 && t - f.last_seen > timeout; }
+
+	std::vector<Flow> flows;	// capacity is a power of two
+	size_t num_flows = 0;
+	size_t num_deleted = 0;
+	uint64_t cumulative_flows = 0;
+	uint64_t packets = 0;
+	uint64_t bytes = 0;
+	double last_purge = 0;
+
+	double timeout;
+	size_t max_flows;
+};
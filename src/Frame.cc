@@ -14,10 +14,36 @@
 
 std::vector<Frame*> g_frame_stack;
 
+// The value arrays of destroyed frames, by size, for reuse by later frames.
+// Calls nest, so a few arrays per size cover the typical depth of the call
+// stack and most frames don't need to allocate one.  These are plain arrays
+// so that frames destroyed during shutdown can still use them.
+static constexpr int max_pooled_frame_size = 32;
+static constexpr int max_pooled_per_size = 16;
+static Val** frame_pool[max_pooled_frame_size + 1][max_pooled_per_size];
+static int frame_pool_len[max_pooled_frame_size + 1];
+
+static Val** alloc_frame_values(int size)
+	{
+	if ( size <= max_pooled_frame_size && frame_pool_len[size] > 0 )
+		return frame_pool[size][--frame_pool_len[size]];
+
+	return new Val*[size];
+	}
+
+static void free_frame_values(Val** values, int size)
+	{
+	if ( size <= max_pooled_frame_size &&
+	     frame_pool_len[size] < max_pooled_per_size )
+		frame_pool[size][frame_pool_len[size]++] = values;
+	else
+		delete [] values;
+	}
+
 Frame::Frame(int arg_size, const BroFunc* func, const zeek::Args* fn_args)
 	{
 	size = arg_size;
-	frame = new Val*[size];
+	frame = alloc_frame_values(size);
 	function = func;
 	func_args = fn_args;
 
@@ -152,7 +178,8 @@ void Frame::Release()
 	for ( int i = 0; i < size; ++i )
 		UnrefElement(i);
 
-	delete [] frame;
+	free_frame_values(frame, size);
+	frame = nullptr;
 	}
 
 void Frame::Describe(ODesc* d) const
@@ -186,6 +213,7 @@ Frame* Frame::Clone() const
 		other->offset_map = std::make_unique<OffsetMap>(*offset_map);
 
 	other->CaptureClosure(closure, outer_ids);
+	other->outer_ids_by_name = outer_ids_by_name;
 
 	other->call = call;
 	other->trigger = trigger;
@@ -196,6 +224,32 @@ Frame* Frame::Clone() const
 	return other;
 	}
 
+Frame* Frame::CloneSlots(const std::vector<int>& slots) const
+	{
+	if ( offset_map )
+		return Clone();
+
+	Frame* other = new Frame(size, function, func_args);
+
+	other->CaptureClosure(closure, outer_ids);
+	other->outer_ids_by_name = outer_ids_by_name;
+
+	other->call = call;
+	other->trigger = trigger;
+
+	for ( auto i : slots )
+		{
+		// Slots of outer IDs belong to the closure and may lie beyond
+		// this frame.
+		if ( i < 0 || i >= size || ! frame[i] )
+			continue;
+
+		other->frame[i] = frame[i]->Clone().release();
+		}
+
+	return other;
+	}
+
 static bool val_is_func(Val* v, BroFunc* func)
 	{
 	if ( v->Type()->Tag() != TYPE_FUNC )
@@ -273,7 +327,10 @@ Frame* Frame::SelectiveClone(const id_list& selection, BroFunc* func) const
 	// other->outer_ids = outer_ids;
 
 	if( closure )
+		{
 		other->CaptureClosure(closure, outer_ids);
+		other->outer_ids_by_name = outer_ids_by_name;
+		}
 
 	if ( offset_map )
 		{
@@ -466,6 +523,7 @@ std::pair<bool, IntrusivePtr<Frame>> Frame::Unserialize(const broker::vector& da
 
 	// Frame takes ownership of unref'ing elements in outer_ids
 	rf->outer_ids = std::move(outer_ids);
+	rf->outer_ids_by_name = true;
 	rf->closure = closure.release();
 	rf->weak_closure_ref = false;
 
@@ -549,6 +607,11 @@ void Frame::UnrefElement(int n)
 
 bool Frame::IsOuterID(const ID* in) const
 	{
+	// Lambda bodies refer to the very IDs their closure captures, so
+	// comparing names is only needed for IDs that came from elsewhere.
+	if ( ! outer_ids_by_name )
+		return std::find(outer_ids.begin(), outer_ids.end(), in) != outer_ids.end();
+
 	return std::any_of(outer_ids.begin(), outer_ids.end(),
 		[&in](ID* id)-> bool { return strcmp(id->Name(), in->Name()) == 0; });
 	}
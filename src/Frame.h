@@ -143,6 +143,18 @@ public:
 	 */
 	Frame* Clone() const;
 
+	/**
+	 * Like Clone(), but only copies the values in the given slots and
+	 * leaves all others unset.  Used for the frames of ``when``
+	 * statements, which only need the locals they refer to.  Falls back
+	 * to a full Clone() for frames received from a remote peer, as
+	 * their layout may differ from the local one.
+	 *
+	 * @param slots the offsets of the values to copy.
+	 * @return a copy of this frame.
+	 */
+	Frame* CloneSlots(const std::vector<int>& slots) const;
+
 	/**
 	 * Clones a Frame, only making copies of the values associated with
 	 * the IDs in selection. Cloning a frame does not deep-copy its
@@ -264,6 +276,13 @@ private:
 	int size;
 
 	bool weak_closure_ref = false;
+
+	/**
+	 * Whether outer IDs need to be matched by name, rather than by
+	 * identity, because they were unserialized.
+	 */
+	bool outer_ids_by_name = false;
+
 	bool break_before_next_stmt;
 	bool break_on_return;
 	bool delayed;
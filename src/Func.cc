@@ -49,6 +49,7 @@
 #include "Event.h"
 #include "Traverse.h"
 #include "Reporter.h"
+#include "ScriptProfiler.h"
 #include "plugin/Manager.h"
 #include "module_util.h"
 #include "iosource/PktSrc.h"
@@ -336,6 +337,11 @@ IntrusivePtr<Val> BroFunc::Call(const zeek::Args& args, Frame* parent) const
 		f->SetCall(parent->GetCall());
 		}
 
+	// A sample that became due while no script was running belongs to
+	// the core, not to the statements about to run.
+	if ( ScriptProfiler::SamplePending() && g_frame_stack.empty() )
+		script_profiler.Sample(nullptr);
+
 	g_frame_stack.push_back(f.get());	// used for backtracing
 	const CallExpr* call_expr = parent ? parent->GetCall() : nullptr;
 	call_stack.emplace_back(CallInfo{call_expr, this, args});
@@ -352,8 +358,22 @@ IntrusivePtr<Val> BroFunc::Call(const zeek::Args& args, Frame* parent) const
 	stmt_flow_type flow = FLOW_NEXT;
 	IntrusivePtr<Val> result;
 
+	// With a single body, the event handler's own timing covers it.
+	bool time_bodies = event_handler_timing && bodies.size() > 1 &&
+	                   Flavor() == FUNC_FLAVOR_EVENT;
+
 	for ( const auto& body : bodies )
 		{
+		LatencyStats::Clock::time_point body_start;
+
+		if ( time_bodies )
+			{
+			if ( ! body.timing )
+				body.timing = std::make_shared<LatencyStats>();
+
+			body_start = LatencyStats::Clock::now();
+			}
+
 		if ( sample_logger )
 			sample_logger->LocationSeen(
 				body.stmts->GetLocationInfo());
@@ -390,6 +410,9 @@ IntrusivePtr<Val> BroFunc::Call(const zeek::Args& args, Frame* parent) const
 			continue;
 			}
 
+		if ( time_bodies )
+			body.timing->AddSince(body_start);
+
 		if ( f->HasDelayed() )
 			{
 			assert(! result);
@@ -567,6 +590,12 @@ void BroFunc::Describe(ODesc* d) const
 		}
 	}
 
+void BroFunc::ReduceBodies(Reducer* r)
+	{
+	for ( auto& body : bodies )
+		body.stmts = body.stmts->Reduce(r);
+	}
+
 IntrusivePtr<Stmt> BroFunc::AddInits(IntrusivePtr<Stmt> body, id_list* inits)
 	{
 	if ( ! inits || inits->length() == 0 )
@@ -634,6 +663,12 @@ IntrusivePtr<Val> BuiltinFunc::Call(const zeek::Args& args, Frame* parent) const
 	const CallExpr* call_expr = parent ? parent->GetCall() : nullptr;
 	call_stack.emplace_back(CallInfo{call_expr, this, args});
 	auto result = std::move(func(parent, &args).rval);
+
+	// Attribute time spent in the built-in function to it rather than
+	// to the statement after its call.
+	if ( ScriptProfiler::SamplePending() )
+		script_profiler.Sample(nullptr);
+
 	call_stack.pop_back();
 
 	if ( result && g_trace_state.DoTrace() )
@@ -757,6 +792,9 @@ void init_builtin_funcs()
 	GapStats = internal_type("GapStats")->AsRecordType();
 	EventStats = internal_type("EventStats")->AsRecordType();
 	TimerStats = internal_type("TimerStats")->AsRecordType();
+	TriggerStats = internal_type("TriggerStats")->AsRecordType();
+	EventHandlerStats = internal_type("EventHandlerStats")->AsRecordType();
+	EventHandlerBodyStats = internal_type("EventHandlerBodyStats")->AsRecordType();
 	FileAnalysisStats = internal_type("FileAnalysisStats")->AsRecordType();
 	ThreadStats = internal_type("ThreadStats")->AsRecordType();
 	BrokerStats = internal_type("BrokerStats")->AsRecordType();
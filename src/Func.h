@@ -15,6 +15,7 @@
 #include "BroList.h"
 #include "Obj.h"
 #include "IntrusivePtr.h"
+#include "LatencyStats.h"
 #include "Type.h" /* for function_flavor */
 #include "TraverseTypes.h"
 #include "ZeekArgs.h"
@@ -27,6 +28,7 @@ class Frame;
 class ID;
 class CallExpr;
 class Scope;
+class Reducer;
 
 class Func : public BroObj {
 public:
@@ -42,6 +44,8 @@ public:
 	struct Body {
 		IntrusivePtr<Stmt> stmts;
 		int priority;
+		// Set up on the first timed call of an event body.
+		mutable std::shared_ptr<LatencyStats> timing;
 		bool operator<(const Body& other) const
 			{ return priority > other.priority; } // reverse sort
 	};
@@ -155,6 +159,11 @@ public:
 	void AddBody(IntrusivePtr<Stmt> new_body, id_list* new_inits,
 		     size_t new_frame_size, int priority) override;
 
+	/**
+	 * Replaces each body by its reduced version, see Stmt::Reduce().
+	 */
+	void ReduceBodies(Reducer* r);
+
 	/** Sets this function's outer_id list. */
 	void SetOuterIDs(id_list ids)
 		{ outer_ids = std::move(ids); }
@@ -0,0 +1,83 @@
+// See the file "COPYING" in the main distribution directory for copyright.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <chrono>
+
+/**
+ * Call count, accumulated time, and a latency histogram for some piece of
+ * code that runs repeatedly, such as an event handler.
+ *
+ * The histogram uses logarithmic buckets: bucket 0 counts durations below
+ * one microsecond, bucket i > 0 those of at least 2^(i-1) and less than
+ * 2^i microseconds.  The last bucket also takes everything longer.  Recording
+ * a duration thus costs a few instructions and the histogram's size is
+ * fixed, no matter the range of the durations.
+ */
+class LatencyStats {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	static constexpr int NUM_BUCKETS = 24;
+
+	/**
+	 * Records one call.
+	 * @param secs the call's duration in seconds.
+	 */
+	void Add(double secs)
+		{
+		++calls;
+		time += secs;
+
+		if ( secs > max )
+			max = secs;
+
+		++buckets[Bucket(secs)];
+		}
+
+	/**
+	 * Records one call that started at the given time and has just
+	 * finished.
+	 * @return the call's duration in seconds.
+	 */
+	double AddSince(Clock::time_point start)
+		{
+		double secs = std::chrono::duration<double>(Clock::now() - start).count();
+		Add(secs);
+		return secs;
+		}
+
+	/**
+	 * @return the histogram bucket that a duration falls into.
+	 */
+	static int Bucket(double secs)
+		{
+		uint64_t usecs = secs > 0 ? uint64_t(secs * 1e6) : 0;
+
+		// The bucket is the position of the highest bit set, as in
+		// CardinalityCounter::flsll().
+#if defined(__GNUC__) || defined(__clang__)
+		int b = usecs ? 64 - __builtin_clzll(usecs) : 0;
+#else
+		int b = 0;
+
+		for ( ; usecs; usecs >>= 1 )
+			++b;
+#endif
+
+		return b < NUM_BUCKETS ? b : NUM_BUCKETS - 1;
+		}
+
+	uint64_t Calls() const	{ return calls; }
+	double Time() const	{ return time; }
+	double Max() const	{ return max; }
+	uint64_t BucketCount(int i) const	{ return buckets[i]; }
+
+private:
+	uint64_t calls = 0;
+	double time = 0;
+	double max = 0;
+	uint64_t buckets[NUM_BUCKETS] = {};
+};
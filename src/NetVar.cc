@@ -132,6 +132,7 @@ TableVal* stp_skip_src;
 double table_expire_interval;
 double table_expire_delay;
 int table_incremental_step;
+bro_uint_t subnet_lookup_trie_max_bytes;
 
 double connection_status_update_interval;
 
@@ -150,6 +151,9 @@ Val* profiling_file;
 double profiling_interval;
 int expensive_profiling_multiple;
 int segment_profiling;
+int event_handler_timing;
+double event_handler_budget;
+TableVal* event_handler_budgets;
 int pkt_profile_mode;
 double pkt_profile_freq;
 Val* pkt_profile_file;
@@ -212,6 +216,7 @@ void init_general_global_var()
 	table_expire_interval = opt_internal_double("table_expire_interval");
 	table_expire_delay = opt_internal_double("table_expire_delay");
 	table_incremental_step = opt_internal_int("table_incremental_step");
+	subnet_lookup_trie_max_bytes = opt_internal_unsigned("subnet_lookup_trie_max_bytes");
 
 	rotate_info = internal_type("rotate_info")->AsRecordType();
 	log_rotate_base_time = opt_internal_string("log_rotate_base_time");
@@ -402,6 +407,10 @@ void init_net_var()
 	profiling_interval = opt_internal_double("profiling_interval");
 	segment_profiling = opt_internal_int("segment_profiling");
 
+	event_handler_timing = opt_internal_int("event_handler_timing");
+	event_handler_budget = opt_internal_double("event_handler_budget");
+	event_handler_budgets = opt_internal_table("event_handler_budgets");
+
 	pkt_profile_mode = opt_internal_int("pkt_profile_mode");
 	pkt_profile_freq = opt_internal_double("pkt_profile_freq");
 	pkt_profile_file = opt_internal_val("pkt_profile_file");
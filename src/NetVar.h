@@ -132,6 +132,7 @@ extern TableVal* stp_skip_src;
 extern double table_expire_interval;
 extern double table_expire_delay;
 extern int table_incremental_step;
+extern bro_uint_t subnet_lookup_trie_max_bytes;
 
 extern int orig_addr_anonymization, resp_addr_anonymization;
 extern int other_addr_anonymization;
@@ -151,6 +152,9 @@ extern double profiling_interval;
 extern int expensive_profiling_multiple;
 
 extern int segment_profiling;
+extern int event_handler_timing;
+extern double event_handler_budget;
+extern TableVal* event_handler_budgets;
 extern int pkt_profile_mode;
 extern double pkt_profile_freq;
 extern Val* pkt_profile_file;
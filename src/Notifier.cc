@@ -21,6 +21,9 @@ notifier::Registry::~Registry()
 	{
 	while ( registrations.begin() != registrations.end() )
 		Unregister(registrations.begin()->first);
+
+	while ( element_registrations.begin() != element_registrations.end() )
+		Unregister(element_registrations.begin()->first);
 	}
 
 void notifier::Registry::Register(Modifiable* m, notifier::Receiver* r)
@@ -31,6 +34,14 @@ void notifier::Registry::Register(Modifiable* m, notifier::Receiver* r)
 	++m->num_receivers;
 	}
 
+void notifier::Registry::Register(Modifiable* m, notifier::Receiver* r, std::string key)
+	{
+	DBG_LOG(DBG_NOTIFIERS, "registering element of object %p for receiver %p", m, r);
+
+	element_registrations[m].insert({std::move(key), r});
+	++m->num_receivers;
+	}
+
 void notifier::Registry::Unregister(Modifiable* m, notifier::Receiver* r)
 	{
 	DBG_LOG(DBG_NOTIFIERS, "unregistering object %p from receiver %p", m, r);
@@ -47,6 +58,31 @@ void notifier::Registry::Unregister(Modifiable* m, notifier::Receiver* r)
 		}
 	}
 
+void notifier::Registry::Unregister(Modifiable* m, notifier::Receiver* r,
+                                    const std::string& key)
+	{
+	DBG_LOG(DBG_NOTIFIERS, "unregistering element of object %p from receiver %p", m, r);
+
+	auto e = element_registrations.find(m);
+
+	if ( e == element_registrations.end() )
+		return;
+
+	auto x = e->second.equal_range(key);
+	for ( auto i = x.first; i != x.second; i++ )
+		{
+		if ( i->second == r )
+			{
+			--m->num_receivers;
+			e->second.erase(i);
+			break;
+			}
+		}
+
+	if ( e->second.empty() )
+		element_registrations.erase(e);
+	}
+
 void notifier::Registry::Unregister(Modifiable* m)
 	{
 	DBG_LOG(DBG_NOTIFIERS, "unregistering object %p from all notifiers", m);
@@ -56,6 +92,14 @@ void notifier::Registry::Unregister(Modifiable* m)
 		--i->first->num_receivers;
 
 	registrations.erase(x.first, x.second);
+
+	auto e = element_registrations.find(m);
+
+	if ( e != element_registrations.end() )
+		{
+		m->num_receivers -= e->second.size();
+		element_registrations.erase(e);
+		}
 	}
 
 void notifier::Registry::Modified(Modifiable* m)
@@ -65,6 +109,30 @@ void notifier::Registry::Modified(Modifiable* m)
 	auto x = registrations.equal_range(m);
 	for ( auto i = x.first; i != x.second; i++ )
 		i->second->Modified(m);
+
+	auto e = element_registrations.find(m);
+
+	if ( e != element_registrations.end() )
+		for ( auto& i : e->second )
+			i.second->Modified(m);
+	}
+
+void notifier::Registry::Modified(Modifiable* m, const std::string& key)
+	{
+	DBG_LOG(DBG_NOTIFIERS, "element of object %p has been modified", m);
+
+	auto x = registrations.equal_range(m);
+	for ( auto i = x.first; i != x.second; i++ )
+		i->second->Modified(m);
+
+	auto e = element_registrations.find(m);
+
+	if ( e == element_registrations.end() )
+		return;
+
+	auto y = e->second.equal_range(key);
+	for ( auto i = y.first; i != y.second; i++ )
+		i->second->Modified(m);
 	}
 
 void notifier::Registry::Terminate()
@@ -74,6 +142,10 @@ void notifier::Registry::Terminate()
 	for ( auto& r : registrations )
 		receivers.emplace(r.second);
 
+	for ( auto& e : element_registrations )
+		for ( auto& r : e.second )
+			receivers.emplace(r.second);
+
 	for ( auto& r : receivers )
 		r->Terminate();
 	}
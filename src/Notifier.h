@@ -8,6 +8,7 @@
 #pragma once
 
 #include <unordered_map>
+#include <string>
 #include <cstdint>
 
 namespace notifier  {
@@ -52,6 +53,23 @@ public:
 	 */
 	void Register(Modifiable* m, Receiver* r);
 
+	/**
+	 * Registers a receiver to be informed when a particular element of
+	 * a modifiable object has changed, such as a single index of a
+	 * table.  The receiver still gets notified about modifications that
+	 * affect the object as a whole.
+	 *
+	 * @param m object to track. Does not take ownership, but the object
+	 * will automatically unregister itself on destruction.
+	 *
+	 * @param r receiver to notify on changes. Does not take ownershop,
+	 * the receiver must remain valid as long as the registration stays
+	 * in place.
+	 *
+	 * @param key the object-specific key identifying the element.
+	 */
+	void Register(Modifiable* m, Receiver* r, std::string key);
+
 	/**
 	 * Cancels a receiver's request to be informed about an object's
 	 * modification. The arguments to the method must match what was
@@ -63,6 +81,19 @@ public:
 	 */
 	void Unregister(Modifiable* m, Receiver* Receiver);
 
+	/**
+	 * Cancels a receiver's request to be informed about modifications
+	 * of an object's element.  The arguments to the method must match
+	 * what was originally registered.
+	 *
+	 * @param m object to no loger track.
+	 *
+	 * @param r receiver to no longer notify.
+	 *
+	 * @param key the element's key.
+	 */
+	void Unregister(Modifiable* m, Receiver* r, const std::string& key);
+
 	/**
 	 * Cancels any active receiver requests to be informed about a
 	 * partilar object's modifications.
@@ -84,8 +115,16 @@ private:
 	// Will be called from the object itself.
 	void Modified(Modifiable* m);
 
+	// Inform the receivers of a modification to one of an object's
+	// elements: those registered for the object as a whole and those
+	// registered for that particular element.
+	void Modified(Modifiable* m, const std::string& key);
+
 	typedef std::unordered_multimap<Modifiable*, Receiver*> ModifiableMap;
 	ModifiableMap registrations;
+
+	typedef std::unordered_multimap<std::string, Receiver*> ElementMap;
+	std::unordered_map<Modifiable*, ElementMap> element_registrations;
 };
 
 /**
@@ -109,6 +148,21 @@ public:
 			registry.Modified(this);
 		}
 
+	/**
+	 * Signals that only the element identified by the given key has
+	 * been modified.  Receivers that registered for other elements
+	 * don't get notified.
+	 *
+	 * @param key the key's bytes.
+	 *
+	 * @param size the key's size.
+	 */
+	void Modified(const void* key, int size)
+		{
+		if ( num_receivers )
+			registry.Modified(this, std::string(static_cast<const char*>(key), size));
+		}
+
 protected:
 	friend class Registry;
 
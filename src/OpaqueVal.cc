@@ -4,6 +4,7 @@
 
 #include "OpaqueVal.h"
 #include "CompHash.h"
+#include "Dict.h"
 #include "NetVar.h"
 #include "Reporter.h"
 #include "Scope.h"
@@ -693,6 +694,52 @@ bool EntropyVal::DoUnserialize(const broker::data& data)
 	return true;
 	}
 
+BroType* probabilistic_batch_elements(Val* v, std::vector<IntrusivePtr<Val>>* elems)
+	{
+	BroType* elem_type = nullptr;
+
+	if ( v->Type()->Tag() == TYPE_VECTOR )
+		{
+		auto vv = v->AsVectorVal();
+		elem_type = vv->Type()->AsVectorType()->YieldType();
+
+		if ( elem_type->Tag() == TYPE_ANY )
+			return nullptr;
+
+		elems->reserve(vv->Size());
+
+		// Holes become null entries so that results still line up with
+		// the vector's indices.
+		for ( unsigned int i = 0; i < vv->Size(); ++i )
+			elems->emplace_back(NewRef{}, vv->Lookup(i));
+		}
+
+	else if ( v->Type()->IsSet() )
+		{
+		auto tv = v->AsTableVal();
+		auto indices = tv->Type()->AsTableType()->IndexTypes();
+
+		if ( indices->length() != 1 || (*indices)[0]->Tag() == TYPE_ANY )
+			return nullptr;
+
+		elem_type = (*indices)[0];
+		elems->reserve(tv->Size());
+
+		const PDict<TableEntryVal>* tbl = tv->AsTable();
+		IterCookie* c = tbl->InitForIteration();
+		HashKey* k;
+
+		while ( tbl->NextEntry(k, c) )
+			{
+			auto lv = tv->RecoverIndex(k);
+			elems->emplace_back(NewRef{}, lv->Index(0));
+			delete k;
+			}
+		}
+
+	return elem_type;
+	}
+
 BloomFilterVal::BloomFilterVal()
 	: OpaqueVal(bloomfilter_type)
 	{
@@ -764,6 +811,57 @@ size_t BloomFilterVal::Count(const Val* val) const
 	return cnt;
 	}
 
+void BloomFilterVal::AddAll(const std::vector<IntrusivePtr<Val>>& vals)
+	{
+	std::vector<HashKey*> keys;
+	keys.reserve(vals.size());
+
+	for ( const auto& v : vals )
+		{
+		if ( ! v )
+			continue;
+
+		if ( auto key = hash->ComputeHash(v.get(), true) )
+			keys.push_back(key);
+		}
+
+	bloom_filter->AddAll(keys);
+
+	for ( auto key : keys )
+		delete key;
+	}
+
+std::vector<size_t> BloomFilterVal::CountAll(const std::vector<IntrusivePtr<Val>>& vals) const
+	{
+	std::vector<size_t> rval(vals.size(), 0);
+	std::vector<HashKey*> keys;
+	std::vector<size_t> idx;
+	keys.reserve(vals.size());
+	idx.reserve(vals.size());
+
+	for ( size_t i = 0; i < vals.size(); ++i )
+		{
+		if ( ! vals[i] )
+			continue;
+
+		if ( auto key = hash->ComputeHash(vals[i].get(), true) )
+			{
+			keys.push_back(key);
+			idx.push_back(i);
+			}
+		}
+
+	auto counts = bloom_filter->CountAll(keys);
+
+	for ( size_t i = 0; i < counts.size(); ++i )
+		rval[idx[i]] = counts[i];
+
+	for ( auto key : keys )
+		delete key;
+
+	return rval;
+	}
+
 void BloomFilterVal::Clear()
 	{
 	bloom_filter->Clear();
@@ -926,6 +1024,24 @@ void CardinalityVal::Add(const Val* val)
 	delete key;
 	}
 
+void CardinalityVal::AddAll(const std::vector<IntrusivePtr<Val>>& vals)
+	{
+	std::vector<uint64_t> hashes;
+	hashes.reserve(vals.size());
+
+	for ( const auto& v : vals )
+		{
+		if ( ! v )
+			continue;
+
+		HashKey* key = hash->ComputeHash(v.get(), true);
+		hashes.push_back(key->Hash());
+		delete key;
+		}
+
+	c->AddElements(hashes.data(), hashes.size());
+	}
+
 IMPLEMENT_OPAQUE_VALUE(CardinalityVal)
 
 broker::expected<broker::data> CardinalityVal::DoSerialize() const
@@ -10,6 +10,8 @@
 
 #include <broker/expected.hh>
 
+#include <vector>
+
 #include <sys/types.h> // for u_char
 
 namespace broker { class data; }
@@ -292,6 +294,17 @@ private:
 	RandTest state;
 };
 
+/**
+ * Collects the elements of a vector, or of a set with a single index type,
+ * for adding them to a probabilistic data structure in one go.
+ * @param v the vector or set.
+ * @param elems receives the elements.  Holes in a vector yield null
+ * entries, which adding skips and counting reports as zero.
+ * @return the type of the elements, or nullptr if *v* is neither of the
+ * above or its elements are of type any.
+ */
+BroType* probabilistic_batch_elements(Val* v, std::vector<IntrusivePtr<Val>>* elems);
+
 class BloomFilterVal : public OpaqueVal {
 public:
 	explicit BloomFilterVal(probabilistic::BloomFilter* bf);
@@ -304,6 +317,8 @@ public:
 
 	void Add(const Val* val);
 	size_t Count(const Val* val) const;
+	void AddAll(const std::vector<IntrusivePtr<Val>>& vals);
+	std::vector<size_t> CountAll(const std::vector<IntrusivePtr<Val>>& vals) const;
 	void Clear();
 	bool Empty() const;
 	std::string InternalState() const;
@@ -336,6 +351,7 @@ public:
 	IntrusivePtr<Val> DoClone(CloneState* state) override;
 
 	void Add(const Val* val);
+	void AddAll(const std::vector<IntrusivePtr<Val>>& vals);
 
 	BroType* Type() const;
 	bool Typify(BroType* type);
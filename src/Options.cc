@@ -43,6 +43,7 @@ void zeek::Options::filter_supervised_node_options()
 	perftools_profile = og.perftools_profile;
 	deterministic_mode = og.deterministic_mode;
 	abort_on_scripting_errors = og.abort_on_scripting_errors;
+	optimize_scripts = og.optimize_scripts;
 
 	pcap_filter = og.pcap_filter;
 	signature_files = og.signature_files;
@@ -101,6 +102,7 @@ void zeek::usage(const char* prog, int code)
 	fprintf(stderr, "    -H|--save-seeds <file>         | save seeds to given file\n");
 	fprintf(stderr, "    -I|--print-id <ID name>        | print out given ID\n");
 	fprintf(stderr, "    -N|--print-plugins             | print available plugins and exit (-NN for verbose)\n");
+	fprintf(stderr, "    -O|--optimize                  | fold constants and drop dead branches in scripts\n");
 	fprintf(stderr, "    -P|--prime-dns                 | prime DNS\n");
 	fprintf(stderr, "    -Q|--time                      | print execution time summary to stderr\n");
 	fprintf(stderr, "    -S|--debug-rules               | enable rule debugging\n");
@@ -114,6 +116,7 @@ void zeek::usage(const char* prog, int code)
 	fprintf(stderr, "    -M|--mem-profile               | record heap [perftools]\n");
 #endif
 	fprintf(stderr, "    --pseudo-realtime[=<speedup>]  | enable pseudo-realtime for performance evaluation (default 1)\n");
+	fprintf(stderr, "    --optimize-dump                | like -O, and print the functions it changed\n");
 	fprintf(stderr, "    -j|--jobs                      | enable supervisor mode\n");
 
 #ifdef USE_IDMEF
@@ -129,8 +132,11 @@ void zeek::usage(const char* prog, int code)
 	fprintf(stderr, "    $ZEEK_SEED_FILE                | file to load seeds from (not set)\n");
 	fprintf(stderr, "    $ZEEK_LOG_SUFFIX               | ASCII log file extension (.%s)\n", logging::writer::Ascii::LogExt().c_str());
 	fprintf(stderr, "    $ZEEK_PROFILER_FILE            | Output file for script execution statistics (not set)\n");
+	fprintf(stderr, "    $ZEEK_SCRIPT_PROFILER_FILE     | Output file for sampled script call stacks (not set)\n");
+	fprintf(stderr, "    $ZEEK_SCRIPT_PROFILER_INTERVAL | CPU time between script call stack samples (0.01)\n");
 	fprintf(stderr, "    $ZEEK_DISABLE_ZEEKYGEN         | Disable Zeekygen documentation support (%s)\n", zeekenv("ZEEK_DISABLE_ZEEKYGEN") ? "set" : "not set");
 	fprintf(stderr, "    $ZEEK_DNS_RESOLVER             | IPv4/IPv6 address of DNS resolver to use (%s)\n", zeekenv("ZEEK_DNS_RESOLVER") ? zeekenv("ZEEK_DNS_RESOLVER") : "not set, will use first IPv4 address from /etc/resolv.conf");
+	fprintf(stderr, "    $ZEEK_DNS_RESOLVER_PORT        | UDP port of the DNS resolver given by $ZEEK_DNS_RESOLVER (53)\n");
 	fprintf(stderr, "    $ZEEK_DEBUG_LOG_STDERR         | Use stderr for debug logs generated via the -B flag");
 
 	fprintf(stderr, "\n");
@@ -209,6 +215,8 @@ zeek::Options zeek::parse_cmdline(int argc, char** argv)
 		{"load-seeds",		required_argument,	nullptr,	'G'},
 		{"save-seeds",		required_argument,	nullptr,	'H'},
 		{"print-plugins",	no_argument,		nullptr,	'N'},
+		{"optimize",		no_argument,		nullptr,	'O'},
+		{"optimize-dump",	no_argument,		nullptr,	'o'},
 		{"prime-dns",		no_argument,		nullptr,	'P'},
 		{"time",		no_argument,		nullptr,	'Q'},
 		{"debug-rules",		no_argument,		nullptr,	'S'},
@@ -236,7 +244,7 @@ zeek::Options zeek::parse_cmdline(int argc, char** argv)
 	};
 
 	char opts[256];
-	safe_strncpy(opts, "B:e:f:G:H:I:i:j::n:p:r:s:T:t:U:w:X:CDFNPQSWabdhv",
+	safe_strncpy(opts, "B:e:f:G:H:I:i:j::n:p:r:s:T:t:U:w:X:CDFNOPQSWabdhv",
 	             sizeof(opts));
 
 #ifdef USE_PERFTOOLS_DEBUG
@@ -358,6 +366,13 @@ zeek::Options zeek::parse_cmdline(int argc, char** argv)
 		case 'N':
 			++rval.print_plugins;
 			break;
+		case 'O':
+			rval.optimize_scripts = true;
+			break;
+		case 'o':
+			rval.optimize_scripts = true;
+			rval.dump_optimized_scripts = true;
+			break;
 		case 'P':
 			if ( rval.dns_mode != DNS_DEFAULT )
 				usage(zargs[0], 1);
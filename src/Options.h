@@ -55,6 +55,8 @@ struct Options {
 	bool perftools_profile = false;
 	bool deterministic_mode = false;
 	bool abort_on_scripting_errors = false;
+	bool optimize_scripts = false;
+	bool dump_optimized_scripts = false;
 
 	bool run_unit_tests = false;
 	std::vector<std::string> doctest_args;
@@ -1,7 +1,213 @@
 #include "PrefixTable.h"
+#include "NetVar.h"
 #include "Reporter.h"
 #include "Val.h"
 
+#include <algorithm>
+#include <vector>
+
+#include "3rdparty/doctest.h"
+
+// A multibit trie with 8-bit strides, built in one go from the patricia tree
+// and never modified afterwards.  Each node is a block of 256 entries, one
+// per value of the next address byte, and all nodes live in one array.  An
+// entry holds the data of the longest prefix that ends within that byte and
+// covers the entry's value, plus the node for the following byte if there
+// are longer prefixes below it.  A lookup thus takes one step per byte and
+// stops as soon as there is nothing more specific.
+//
+// IPv4 prefixes go into a trie of their own, so that IPv4 lookups take at
+// most four steps instead of first walking through the v4-mapped range.
+//
+// Each node takes 2 KiB, and a prefix needs up to one node per byte beyond
+// the first, so sparse or long (e.g. IPv6 /64 and longer) prefixes are
+// expensive.  Build() gives up once the nodes exceed a budget.
+class PrefixTable::Snapshot {
+public:
+	// Fills the trie from the tree.  Returns false if that would take
+	// more than max_bytes.
+	bool Build(patricia_tree_t* tree, uint64_t max_bytes);
+
+	void* Lookup(const IPAddr& addr) const
+		{
+		const uint32_t* words;
+		int n = addr.GetBytes(&words) * sizeof(uint32_t);
+		const uint8_t* bytes = reinterpret_cast<const uint8_t*>(words);
+
+		bool v4 = n == 4;
+		uint32_t node = v4 ? V4_ROOT : V6_ROOT;
+		uint32_t best = v4 ? v4_default : v6_default;
+
+		for ( int i = 0; i < n; ++i )
+			{
+			const Entry& e = entries[node * FANOUT + bytes[i]];
+
+			if ( e.data )
+				best = e.data;
+
+			if ( ! e.node )
+				break;
+
+			node = e.node;
+			}
+
+		return best ? data[best - 1] : nullptr;
+		}
+
+private:
+	struct Entry {
+		uint32_t node;	// 0 if none; the roots are never children
+		uint32_t data;	// index into data plus one, 0 if none
+	};
+
+	enum { STRIDE = 8, FANOUT = 1 << STRIDE, V6_ROOT = 0, V4_ROOT = 1 };
+
+	// Returns 0 if the node would exceed the budget.
+	uint32_t NewNode()
+		{
+		if ( entries.size() + FANOUT > max_entries )
+			return 0;
+
+		entries.resize(entries.size() + FANOUT);
+		return entries.size() / FANOUT - 1;
+		}
+
+	// Adds a prefix of the given bit length, which must be larger than
+	// any length added before.  Returns false if out of budget.
+	bool Add(uint32_t node, const uint8_t* bytes, int len, uint32_t d);
+
+	std::vector<Entry> entries;
+	std::vector<void*> data;
+	uint32_t v6_default = 0;
+	uint32_t v4_default = 0;
+	uint64_t max_entries = 0;
+};
+
+bool PrefixTable::Snapshot::Build(patricia_tree_t* tree, uint64_t max_bytes)
+	{
+	max_entries = max_bytes / sizeof(Entry);
+
+	// The two roots.
+	if ( max_entries < 2 * FANOUT )
+		return false;
+
+	// The v4-mapped range as a prefix.
+	static const uint8_t v4_range[12] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff };
+
+	std::vector<patricia_node_t*> nodes;
+	std::vector<patricia_node_t*> stack;
+
+	if ( tree->head )
+		stack.push_back(tree->head);
+
+	while ( ! stack.empty() )
+		{
+		patricia_node_t* n = stack.back();
+		stack.pop_back();
+
+		if ( n->prefix )
+			nodes.push_back(n);
+
+		if ( n->r )
+			stack.push_back(n->r);
+
+		if ( n->l )
+			stack.push_back(n->l);
+		}
+
+	std::stable_sort(nodes.begin(), nodes.end(),
+	                 [](const patricia_node_t* a, const patricia_node_t* b)
+	                 { return a->prefix->bitlen < b->prefix->bitlen; });
+
+	NewNode();
+	NewNode();
+	data.reserve(nodes.size());
+
+	for ( auto n : nodes )
+		{
+		const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&n->prefix->add.sin6);
+		int len = n->prefix->bitlen;
+
+		data.push_back(n->data);
+		uint32_t d = data.size();
+
+		// Number of leading bits shared with the v4-mapped range.
+		int common = 0;
+
+		while ( common < 96 && common < len &&
+		        ! ((bytes[common / 8] ^ v4_range[common / 8]) & (0x80 >> (common % 8))) )
+			++common;
+
+		if ( common == 96 )
+			{
+			// Within the v4-mapped range, only IPv4 lookups can match.
+			if ( len == 96 )
+				v4_default = d;
+			else if ( ! Add(V4_ROOT, bytes + 12, len - 96, d) )
+				return false;
+
+			continue;
+			}
+
+		if ( common == len )
+			// Covers the whole v4-mapped range.
+			v4_default = d;
+
+		if ( len == 0 )
+			v6_default = d;
+		else if ( ! Add(V6_ROOT, bytes, len, d) )
+			return false;
+		}
+
+	return true;
+	}
+
+bool PrefixTable::Snapshot::Add(uint32_t node, const uint8_t* bytes, int len, uint32_t d)
+	{
+	int i = 0;
+
+	for ( ; len > STRIDE * (i + 1); ++i )
+		{
+		uint32_t idx = node * FANOUT + bytes[i];
+
+		if ( ! entries[idx].node )
+			{
+			// Creating the node may reallocate the entries.
+			uint32_t child = NewNode();
+
+			if ( ! child )
+				return false;
+
+			entries[idx].node = child;
+			}
+
+		node = entries[idx].node;
+		}
+
+	// The prefix ends within this byte; it covers all values that agree
+	// in its remaining bits.
+	int span = 1 << (STRIDE * (i + 1) - len);
+	int first = bytes[i] & ~(span - 1);
+
+	for ( int j = first; j < first + span; ++j )
+		entries[node * FANOUT + j].data = d;
+
+	return true;
+	}
+
+PrefixTable::PrefixTable()
+	{
+	tree = New_Patricia(128);
+	delete_function = nullptr;
+	lookups = 0;
+	snapshot_too_large = false;
+	}
+
+PrefixTable::~PrefixTable()
+	{
+	Destroy_Patricia(tree, delete_function);
+	}
+
 prefix_t* PrefixTable::MakePrefix(const IPAddr& addr, int width)
 	{
 	prefix_t* prefix = (prefix_t*) safe_malloc(sizeof(prefix_t));
@@ -36,6 +242,7 @@ void* PrefixTable::Insert(const IPAddr& addr, int width, void* data)
 	// If there is no data to be associated with addr, we take the
 	// node itself.
 	node->data = data ? data : node;
+	Changed();
 
 	return old;
 	}
@@ -86,16 +293,48 @@ std::list<std::tuple<IPPrefix,void*>> PrefixTable::FindAll(const SubNetVal* valu
 	return FindAll(value->AsSubNet().Prefix(), value->AsSubNet().LengthIPv6());
 	}
 
+void* PrefixTable::LookupBest(const IPAddr& addr) const
+	{
+	if ( ! snapshot )
+		{
+		if ( snapshot_too_large || ! subnet_lookup_trie_max_bytes )
+			return nullptr;
+
+		// Building the snapshot takes time linear in the number of
+		// prefixes, so only do so once lookups have made up for it.
+		if ( ++lookups <= uint64_t(tree->num_active_node) + 64 )
+			return nullptr;
+
+		std::unique_ptr<Snapshot> s(new Snapshot);
+
+		if ( ! s->Build(tree, subnet_lookup_trie_max_bytes) )
+			{
+			// Stick with patricia until the next modification.
+			snapshot_too_large = true;
+			return nullptr;
+			}
+
+		snapshot = std::move(s);
+		}
+
+	return snapshot->Lookup(addr);
+	}
+
 void* PrefixTable::Lookup(const IPAddr& addr, int width, bool exact) const
 	{
+	if ( width == 128 && ! exact )
+		{
+		void* d = LookupBest(addr);
+
+		if ( snapshot )
+			return d;
+		}
+
 	prefix_t* prefix = MakePrefix(addr, width);
 	patricia_node_t* node =
 		exact ? patricia_search_exact(tree, prefix) :
 			patricia_search_best(tree, prefix);
 
-	int elems = 0;
-	patricia_node_t** list = nullptr;
-
 	Deref_Prefix(prefix);
 	return node ? node->data : nullptr;
 	}
@@ -135,6 +374,7 @@ void* PrefixTable::Remove(const IPAddr& addr, int width)
 
 	void* old = node->data;
 	patricia_remove(tree, node);
+	Changed();
 
 	return old;
 	}
@@ -162,6 +402,19 @@ void* PrefixTable::Remove(const Val* value)
 	}
 	}
 
+void PrefixTable::Clear()
+	{
+	Clear_Patricia(tree, delete_function);
+	Changed();
+	}
+
+void PrefixTable::Changed()
+	{
+	snapshot.reset();
+	snapshot_too_large = false;
+	lookups = 0;
+	}
+
 PrefixTable::iterator PrefixTable::InitIterator()
 	{
 	iterator i;
@@ -202,3 +455,74 @@ void* PrefixTable::GetNext(iterator* i)
 
 	// Not reached.
 	}
+
+TEST_CASE("prefix table snapshot")
+	{
+	auto max_bytes = subnet_lookup_trie_max_bytes;
+	subnet_lookup_trie_max_bytes = 64 * 1024 * 1024;
+
+	PrefixTable pt;
+	std::vector<IPAddr> addrs;
+	uint32_t state = 42;
+
+	auto next = [&state]()
+		{
+		state = state * 1103515245 + 12345;
+		return state;
+		};
+
+	// Prefixes covering the v4-mapped range, or parts of it.
+	pt.Insert(IPAddr("::"), 8, (void*)1);
+	pt.Insert(IPAddr("::ffff:0.0.0.0"), 100, (void*)2);
+	pt.Insert(IPAddr("2001:db8::"), 32, (void*)3);
+	pt.Insert(IPAddr("2001:db8::"), 37, (void*)4);
+
+	for ( uintptr_t i = 0; i < 500; ++i )
+		{
+		uint32_t a = next();
+		int len = 8 + next() % 25;
+		pt.Insert(IPAddr(IPv4, &a, IPAddr::Host), 96 + len, (void*)(i + 10));
+		addrs.emplace_back(IPv4, &a, IPAddr::Host);
+		addrs.back().Mask(96 + len + next() % (33 - len));
+		}
+
+	addrs.emplace_back("2001:db8::1");
+	addrs.emplace_back("2001:db8:ff00::1");
+	addrs.emplace_back("::1");
+	addrs.emplace_back("fe80::1");
+	addrs.emplace_back("1.2.3.4");
+	addrs.emplace_back("255.255.255.255");
+
+	std::vector<void*> expected;
+
+	for ( const auto& a : addrs )
+		expected.push_back(pt.Lookup(a, 128));
+
+	CHECK(expected[addrs.size() - 6] == (void*)4);
+	CHECK(expected[addrs.size() - 5] == (void*)3);
+	CHECK(expected[addrs.size() - 4] == (void*)1);
+	CHECK(expected[addrs.size() - 3] == nullptr);
+
+	// Enough lookups to have the snapshot built.
+	for ( int round = 0; round < 10; ++round )
+		for ( size_t i = 0; i < addrs.size(); ++i )
+			CHECK(pt.Lookup(addrs[i], 128) == expected[i]);
+
+	pt.Insert(IPAddr("::"), 0, (void*)5);
+	CHECK(pt.Lookup(IPAddr("fe80::1"), 128) == (void*)5);
+
+	pt.Remove(IPAddr("::"), 0);
+	CHECK(pt.Lookup(IPAddr("fe80::1"), 128) == nullptr);
+
+	// A trie that doesn't fit the budget leaves lookups to patricia.
+	subnet_lookup_trie_max_bytes = 4 * 2048;
+	pt.Insert(IPAddr("::"), 0, (void*)5);
+
+	for ( int round = 0; round < 10; ++round )
+		for ( size_t i = 0; i < addrs.size() - 6; ++i )
+			CHECK(pt.Lookup(addrs[i], 128) == expected[i]);
+
+	CHECK(pt.Lookup(IPAddr("fe80::1"), 128) == (void*)5);
+
+	subnet_lookup_trie_max_bytes = max_bytes;
+	}
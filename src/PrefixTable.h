@@ -5,6 +5,7 @@ extern "C" {
 }
 
 #include <list>
+#include <memory>
 
 #include "IPAddr.h"
 
@@ -21,8 +22,8 @@ private:
 	};
 
 public:
-	PrefixTable()	{ tree = New_Patricia(128); delete_function = nullptr; }
-	~PrefixTable()	{ Destroy_Patricia(tree, delete_function); }
+	PrefixTable();
+	~PrefixTable();
 
 	// Addr in network byte order. If data is zero, acts like a set.
 	// Returns ptr to old data if already existing.
@@ -35,6 +36,13 @@ public:
 	// Returns nil if not found, pointer to data otherwise.
 	// For items without data, returns non-nil if found.
 	// If exact is false, performs exact rather than longest-prefix match.
+	//
+	// Once a table gets looked up much more often than it changes,
+	// longest-prefix matches of single addresses are answered from a
+	// compact, read-only copy of the tree that's rebuilt after the next
+	// modification only when lookups dominate again.  The copy's size is
+	// bounded by subnet_lookup_trie_max_bytes; tables that would need
+	// more keep using the tree.
 	void* Lookup(const IPAddr& addr, int width, bool exact = false) const;
 	void* Lookup(const Val* value, bool exact = false) const;
 
@@ -46,7 +54,7 @@ public:
 	void* Remove(const IPAddr& addr, int width);
 	void* Remove(const Val* value);
 
-	void Clear()	{ Clear_Patricia(tree, delete_function); }
+	void Clear();
 
 	// Sets a function to call for each node when table is cleared/destroyed.
 	void SetDeleteFunction(data_fn_t del_fn)	{ delete_function = del_fn; }
@@ -55,9 +63,21 @@ public:
 	void* GetNext(iterator* i);
 
 private:
+	class Snapshot;
+
 	static prefix_t* MakePrefix(const IPAddr& addr, int width);
 	static IPPrefix PrefixToIPPrefix(prefix_t* p);
 
+	// Longest-prefix match of a single address.
+	void* LookupBest(const IPAddr& addr) const;
+
+	// Drops the snapshot after the tree got modified.
+	void Changed();
+
 	patricia_tree_t* tree;
 	data_fn_t delete_function;
+
+	mutable std::unique_ptr<Snapshot> snapshot;
+	mutable uint64_t lookups;	// since the last modification
+	mutable bool snapshot_too_large;	// since the last modification
 };
@@ -0,0 +1,189 @@
+// See the file "COPYING" in the main distribution directory for copyright.
+
+#include "zeek-config.h"
+#include "Reduce.h"
+
+#include <cinttypes>
+#include <unordered_set>
+#include <vector>
+
+#include "Desc.h"
+#include "Expr.h"
+#include "Func.h"
+#include "ID.h"
+#include "Reporter.h"
+#include "Scope.h"
+#include "Stmt.h"
+#include "Val.h"
+#include "plugin/Manager.h"
+
+// Returns the constant that a function body always returns, or null if
+// the body does anything but that.
+static Val* constant_return(const Stmt* s)
+	{
+	while ( s->Tag() == STMT_LIST )
+		{
+		const Stmt* only = nullptr;
+
+		for ( const auto& sub : s->AsStmtList()->Stmts() )
+			{
+			if ( sub->Tag() == STMT_INIT )
+				// Initializes locals that are thus unused.
+				continue;
+
+			if ( only )
+				return nullptr;
+
+			only = sub;
+			}
+
+		if ( ! only )
+			return nullptr;
+
+		s = only;
+		}
+
+	if ( s->Tag() != STMT_RETURN )
+		return nullptr;
+
+	const Expr* e = static_cast<const ReturnStmt*>(s)->StmtExpr();
+
+	if ( ! e || ! e->IsConst() || ! Reducer::IsFoldableType(e->Type()) )
+		return nullptr;
+
+	return e->ExprVal();
+	}
+
+void Reducer::ReduceGlobalFunctions(FILE* dump)
+	{
+	std::vector<BroFunc*> reduced;
+
+	for ( const auto& entry : global_scope()->Vars() )
+		{
+		ID* id = entry.second.get();
+
+		if ( id->AsType() || ! id->HasVal() || id->Type()->Tag() != TYPE_FUNC )
+			continue;
+
+		Func* f = id->ID_Val()->AsFunc();
+
+		if ( f->GetKind() != Func::BRO_FUNC )
+			continue;
+
+		reduced.push_back(static_cast<BroFunc*>(f));
+		ReduceFunction(reduced.back());
+		}
+
+	if ( ! dump )
+		return;
+
+	std::unordered_set<const BroFunc*> dumped;
+
+	for ( auto f : reduced )
+		{
+		if ( ! funcs[f].changed || ! dumped.insert(f).second )
+			continue;
+
+		fprintf(dump, "%s %s\n", f->FType()->FlavorString().c_str(), f->Name());
+
+		for ( const auto& body : f->GetBodies() )
+			{
+			ODesc d;
+			body.stmts->Describe(&d);
+			fprintf(dump, "%s\n", d.Description());
+			}
+		}
+
+	fprintf(dump, "# reduced %" PRIu64 " folded, %" PRIu64 " constants, %"
+	        PRIu64 " branches, %" PRIu64 " calls\n",
+	        stats.folded, stats.consts, stats.branches, stats.calls);
+	}
+
+void Reducer::ReduceFunction(BroFunc* f)
+	{
+	if ( funcs.count(f) )
+		return;
+
+	FuncInfo* info = &funcs[f];
+	FuncInfo* caller = current;
+
+	current = info;
+	f->ReduceBodies(this);
+	current = caller;
+
+	const auto& bodies = f->GetBodies();
+
+	if ( f->Flavor() == FUNC_FLAVOR_FUNCTION && bodies.size() == 1 )
+		info->result = constant_return(bodies[0].stmts.get());
+
+	info->done = true;
+	}
+
+Val* Reducer::ConstantResult(Func* f)
+	{
+	if ( f->GetKind() != Func::BRO_FUNC || f->Flavor() != FUNC_FLAVOR_FUNCTION )
+		return nullptr;
+
+	if ( plugin_mgr->HavePluginForHook(plugin::HOOK_CALL_FUNCTION) )
+		// A plugin may want to see, or change, the call.
+		return nullptr;
+
+	auto bf = static_cast<BroFunc*>(f);
+	ReduceFunction(bf);
+
+	const auto& info = funcs[bf];
+	return info.done ? info.result : nullptr;
+	}
+
+IntrusivePtr<Expr> Reducer::TryFold(Expr* e)
+	{
+	if ( ! IsFoldableType(e->Type()) )
+		return {NewRef{}, e};
+
+	IntrusivePtr<Val> v;
+
+	try
+		{
+		v = e->Eval(nullptr);
+		}
+
+	catch ( InterpreterException& )
+		{
+		return {NewRef{}, e};
+		}
+
+	if ( ! v )
+		return {NewRef{}, e};
+
+	Folded();
+	return Replace(e, std::move(v));
+	}
+
+IntrusivePtr<Expr> Reducer::Replace(const Expr* e, IntrusivePtr<Val> v)
+	{
+	auto c = make_intrusive<ConstExpr>(std::move(v));
+	c->SetLocationInfo(e->GetLocationInfo());
+	return c;
+	}
+
+bool Reducer::IsFoldableType(const BroType* t)
+	{
+	switch ( t->Tag() ) {
+	case TYPE_BOOL:
+	case TYPE_INT:
+	case TYPE_COUNT:
+	case TYPE_COUNTER:
+	case TYPE_DOUBLE:
+	case TYPE_TIME:
+	case TYPE_INTERVAL:
+	case TYPE_STRING:
+	case TYPE_PORT:
+	case TYPE_ADDR:
+	case TYPE_SUBNET:
+	case TYPE_ENUM:
+		return true;
+
+	default:
+		return false;
+	}
+	}
@@ -0,0 +1,115 @@
+// See the file "COPYING" in the main distribution directory for copyright.
+
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include <unordered_map>
+
+#include "IntrusivePtr.h"
+
+class BroFunc;
+class BroType;
+class Expr;
+class Func;
+class Stmt;
+class Val;
+
+/**
+ * Simplifies the bodies of script functions after parsing: folds
+ * expressions whose operands are constants, replaces references to
+ * ``const`` globals of atomic types with their values, drops ``if`` and
+ * ``while`` statements whose condition is constant, and replaces calls of
+ * functions that always return the same constant with that constant.
+ *
+ * This assumes that the values of ``const`` globals don't change after
+ * parsing, which only updates via ``Broker::publish_id`` could violate.
+ * ``option`` globals remain untouched, since the configuration framework
+ * may change them at any time.
+ *
+ * The individual simplifications are the Reduce() methods of Expr and Stmt.
+ */
+class Reducer {
+public:
+	/**
+	 * Counts of the simplifications done so far.
+	 */
+	struct Stats {
+		uint64_t folded = 0;	//! Expressions folded into constants.
+		uint64_t consts = 0;	//! References to constants inlined.
+		uint64_t branches = 0;	//! Statements or expressions with a constant condition removed.
+		uint64_t calls = 0;	//! Calls replaced by their constant result.
+	};
+
+	/**
+	 * Reduces the bodies of all script functions, events, and hooks in
+	 * the global scope.
+	 *
+	 * @param dump if non-null, the file to describe each function changed
+	 * by the reduction to, followed by a summary.
+	 */
+	void ReduceGlobalFunctions(FILE* dump = nullptr);
+
+	/**
+	 * Reduces the bodies of a single function, unless that's already
+	 * done.
+	 */
+	void ReduceFunction(BroFunc* f);
+
+	/**
+	 * Returns the value that each call of a function evaluates to, if
+	 * that's the same constant no matter the arguments.  Reduces the
+	 * function first if necessary.
+	 *
+	 * @return the value, or null if the function isn't a plain
+	 * function with a single constant return statement, or is in the
+	 * middle of being reduced (i.e., is recursive).
+	 */
+	Val* ConstantResult(Func* f);
+
+	/**
+	 * Evaluates an expression whose operands are all constants.
+	 *
+	 * @return a constant expression with the result, or the expression
+	 * itself if its type isn't foldable or evaluating it fails.
+	 */
+	IntrusivePtr<Expr> TryFold(Expr* e);
+
+	/**
+	 * Returns a constant expression holding the given value, with the
+	 * location of the expression it replaces.
+	 */
+	IntrusivePtr<Expr> Replace(const Expr* e, IntrusivePtr<Val> v);
+
+	/**
+	 * @return true if values of the given type are immutable and cheap
+	 * to describe, so it's fine to turn them into constant expressions.
+	 */
+	static bool IsFoldableType(const BroType* t);
+
+	// Called by the Reduce() methods to count what they did.
+	void Folded()	{ ++stats.folded; Changed(); }
+	void InlinedConst()	{ ++stats.consts; Changed(); }
+	void RemovedBranch()	{ ++stats.branches; Changed(); }
+	void InlinedCall()	{ ++stats.calls; Changed(); }
+
+	const Stats& GetStats() const	{ return stats; }
+
+private:
+	struct FuncInfo {
+		bool done = false;
+		bool changed = false;
+		Val* result = nullptr;
+	};
+
+	void Changed()
+		{
+		if ( current )
+			current->changed = true;
+		}
+
+	std::unordered_map<const BroFunc*, FuncInfo> funcs;
+	FuncInfo* current = nullptr;
+	Stats stats;
+};
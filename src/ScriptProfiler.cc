@@ -0,0 +1,177 @@
+// See the file "COPYING" in the main distribution directory for copyright.
+
+#include "zeek-config.h"
+#include "ScriptProfiler.h"
+
+#include <sys/time.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "Func.h"
+#include "Stmt.h"
+#include "Reporter.h"
+#include "util.h"
+
+extern "C" {
+#include "setsignal.h"
+};
+
+ScriptProfiler script_profiler;
+
+volatile sig_atomic_t ScriptProfiler::sample_pending = 0;
+
+// Replaces the characters that have a meaning in the folded format.
+static void append_frame(std::string* stack, const char* frame)
+	{
+	if ( ! stack->empty() )
+		stack->push_back(';');
+
+	for ( const char* p = frame; *p; ++p )
+		stack->push_back(*p == ';' || *p == ' ' ? '_' : *p);
+	}
+
+ScriptProfiler::~ScriptProfiler()
+	{
+	if ( running )
+		Stop();
+	}
+
+void ScriptProfiler::SignalHandler(int /* signo */)
+	{
+	sample_pending = 1;
+	}
+
+bool ScriptProfiler::Start(double interval)
+	{
+	if ( interval < 0.001 )
+		interval = 0.001;
+
+	if ( ! running && setsignal(SIGPROF, SignalHandler) == SIG_ERR )
+		{
+		reporter->Error("cannot install script profiler's signal handler: %s",
+		                strerror(errno));
+		return false;
+		}
+
+	struct itimerval it;
+	it.it_interval.tv_sec = time_t(interval);
+	it.it_interval.tv_usec = suseconds_t((interval - double(it.it_interval.tv_sec)) * 1e6);
+	it.it_value = it.it_interval;
+
+	if ( setitimer(ITIMER_PROF, &it, nullptr) < 0 )
+		{
+		reporter->Error("cannot start script profiler's timer: %s",
+		                strerror(errno));
+
+		if ( ! running )
+			setsignal(SIGPROF, SIG_IGN);
+
+		return false;
+		}
+
+	running = true;
+	return true;
+	}
+
+void ScriptProfiler::Stop()
+	{
+	if ( ! running )
+		return;
+
+	struct itimerval it = {};
+	setitimer(ITIMER_PROF, &it, nullptr);
+	setsignal(SIGPROF, SIG_IGN);
+
+	running = false;
+	sample_pending = 0;
+	}
+
+void ScriptProfiler::Reset()
+	{
+	stacks.clear();
+	num_samples = 0;
+	}
+
+void ScriptProfiler::Sample(const Stmt* stmt)
+	{
+	sample_pending = 0;
+
+	if ( ! running )
+		return;
+
+	std::string stack;
+
+	for ( const auto& ci : call_stack )
+		append_frame(&stack, ci.func->Name());
+
+	if ( stmt )
+		{
+		const Location* loc = stmt->GetLocationInfo();
+
+		if ( loc && loc->filename )
+			append_frame(&stack, fmt("%s:%d", loc->filename, loc->first_line));
+		}
+
+	if ( stack.empty() )
+		stack = "<native>";
+
+	++stacks[stack];
+	++num_samples;
+	}
+
+bool ScriptProfiler::WriteFolded(const std::string& file) const
+	{
+	FILE* f = fopen(file.c_str(), "w");
+
+	if ( ! f )
+		{
+		reporter->Error("cannot open script profile %s: %s", file.c_str(),
+		                strerror(errno));
+		return false;
+		}
+
+	std::vector<std::pair<std::string, uint64_t>> sorted(stacks.begin(), stacks.end());
+	std::sort(sorted.begin(), sorted.end());
+
+	for ( const auto& s : sorted )
+		fprintf(f, "%s %" PRIu64 "\n", s.first.c_str(), s.second);
+
+	if ( fclose(f) != 0 )
+		{
+		reporter->Error("cannot write script profile %s: %s", file.c_str(),
+		                strerror(errno));
+		return false;
+		}
+
+	return true;
+	}
+
+void ScriptProfiler::InitFromEnv()
+	{
+	if ( ! zeekenv("ZEEK_SCRIPT_PROFILER_FILE") )
+		return;
+
+	double interval = 0.01;
+
+	if ( const char* i = zeekenv("ZEEK_SCRIPT_PROFILER_INTERVAL") )
+		interval = atof(i);
+
+	Start(interval);
+	}
+
+void ScriptProfiler::DoneFromEnv()
+	{
+	const char* file = zeekenv("ZEEK_SCRIPT_PROFILER_FILE");
+
+	if ( ! file )
+		return;
+
+	Stop();
+	WriteFolded(file);
+	}
@@ -0,0 +1,106 @@
+// See the file "COPYING" in the main distribution directory for copyright.
+
+#pragma once
+
+#include <signal.h>
+#include <stdint.h>
+
+#include <string>
+#include <unordered_map>
+
+class Stmt;
+
+/**
+ * A sampling profiler for script code.  A CPU-time interval timer
+ * periodically flags that a sample is due, and the interpreter takes it
+ * at the next statement it executes, or when a built-in function returns,
+ * by recording the current script call stack along with the location of
+ * that statement.  Samples that arrive while no script code runs are
+ * counted separately.
+ *
+ * The recorded stacks can be written in the "folded" format that
+ * flame graph tools take as input: one line per distinct stack, with the
+ * frames separated by semicolons, followed by the number of samples.
+ */
+class ScriptProfiler {
+public:
+	ScriptProfiler() = default;
+	~ScriptProfiler();
+
+	/**
+	 * Starts taking samples.  If the profiler is running already, just
+	 * changes the interval.
+	 *
+	 * @param interval the CPU time between two samples, in seconds.
+	 *
+	 * @return false if the interval timer couldn't be set up.
+	 */
+	bool Start(double interval);
+
+	/**
+	 * Stops taking samples.  The samples taken so far remain available.
+	 */
+	void Stop();
+
+	/**
+	 * @return true if the profiler is currently taking samples.
+	 */
+	bool Running() const	{ return running; }
+
+	/**
+	 * Discards all samples taken so far.
+	 */
+	void Reset();
+
+	/**
+	 * Writes the samples taken so far in folded format.
+	 *
+	 * @param file the name of the file to write to.
+	 *
+	 * @return false if the file couldn't be written.
+	 */
+	bool WriteFolded(const std::string& file) const;
+
+	/**
+	 * Starts the profiler if the environment variable
+	 * ZEEK_SCRIPT_PROFILER_FILE is set, using the interval from
+	 * ZEEK_SCRIPT_PROFILER_INTERVAL if set.
+	 */
+	void InitFromEnv();
+
+	/**
+	 * Writes the samples to the file given by ZEEK_SCRIPT_PROFILER_FILE,
+	 * if set.
+	 */
+	void DoneFromEnv();
+
+	/**
+	 * @return the number of samples taken so far.
+	 */
+	uint64_t NumSamples() const	{ return num_samples; }
+
+	/**
+	 * @return true if the timer has signaled that a sample is due.
+	 */
+	static bool SamplePending()	{ return sample_pending; }
+
+	/**
+	 * Takes a pending sample.
+	 *
+	 * @param stmt the statement about to be executed, or null if the
+	 * sample shouldn't include a location.
+	 */
+	void Sample(const Stmt* stmt);
+
+private:
+	static void SignalHandler(int signo);
+
+	static volatile sig_atomic_t sample_pending;
+
+	// Number of samples for each distinct stack.
+	std::unordered_map<std::string, uint64_t> stacks;
+	uint64_t num_samples = 0;
+	bool running = false;
+};
+
+extern ScriptProfiler script_profiler;
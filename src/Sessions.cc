@@ -16,6 +16,7 @@
 #include "Timer.h"
 #include "NetVar.h"
 #include "Reporter.h"
+#include "Var.h"
 
 #include "analyzer/protocol/icmp/ICMP.h"
 #include "analyzer/protocol/udp/UDP.h"
@@ -78,6 +79,7 @@ NetSessions::NetSessions()
 		}
 
 	packet_filter = nullptr;
+	bypass_after_bytes = opt_internal_unsigned("flow_bypass_after_bytes");
 
 	dump_this_packet = false;
 	num_packets_processed = 0;
@@ -247,6 +249,9 @@ void NetSessions::DoNextPacket(double t, const Packet* pkt, const IP_Hdr* ip_hdr
 		return;
 		}
 
+	if ( flow_bypass.NextPacket(t, ip_hdr, len, caplen) )
+		return;
+
 	// Ignore if packet matches packet filter.
 	if ( packet_filter && packet_filter->Match(ip_hdr, len, caplen) )
 		 return;
@@ -703,6 +708,11 @@ void NetSessions::DoNextPacket(double t, const Packet* pkt, const IP_Hdr* ip_hdr
 	conn->NextPacket(t, is_orig, ip_hdr, len, caplen, data,
 				record_packet, record_content, pkt);
 
+	if ( bypass_after_bytes && ! conn->Skipping() &&
+	     conn->PayloadBytes() >= bypass_after_bytes &&
+	     (! conn->GetRootAnalyzer() || conn->GetRootAnalyzer()->ChildrenFinished()) )
+		Bypass(conn);
+
 	if ( f )
 		{
 		// Above we already recorded the fragment in its entirety.
@@ -911,7 +921,7 @@ Connection* NetSessions::FindConnection(Val* v)
 		return nullptr;
 
 	RecordType* vr = vt->AsRecordType();
-	const val_list* vl = v->AsRecord();
+	const RecordVal* rv = v->AsRecordVal();
 
 	int orig_h, orig_p;	// indices into record's value list
 	int resp_h, resp_p;
@@ -939,11 +949,11 @@ Connection* NetSessions::FindConnection(Val* v)
 		// types, too.
 		}
 
-	const IPAddr& orig_addr = (*vl)[orig_h]->AsAddr();
-	const IPAddr& resp_addr = (*vl)[resp_h]->AsAddr();
+	IPAddr orig_addr = rv->FieldAddr(orig_h);
+	IPAddr resp_addr = rv->FieldAddr(resp_h);
 
-	PortVal* orig_portv = (*vl)[orig_p]->AsPortVal();
-	PortVal* resp_portv = (*vl)[resp_p]->AsPortVal();
+	PortVal* orig_portv = rv->Lookup(orig_p)->AsPortVal();
+	PortVal* resp_portv = rv->Lookup(resp_p)->AsPortVal();
 
 	ConnID id;
 
@@ -1126,6 +1136,19 @@ void NetSessions::Clear()
 	fragments.clear();
 	}
 
+bool NetSessions::Bypass(Connection* c)
+	{
+	if ( c->ConnTransport() != TRANSPORT_TCP &&
+	     c->ConnTransport() != TRANSPORT_UDP )
+		return false;
+
+	if ( ! flow_bypass.Add(c->Key(), c->ConnTransport(), network_time) )
+		return false;
+
+	c->SetSkip(true);
+	return true;
+	}
+
 void NetSessions::GetStats(SessionStats& s) const
 	{
 	s.num_TCP_conns = tcp_conns.size();
@@ -1141,6 +1164,8 @@ void NetSessions::GetStats(SessionStats& s) const
 	s.max_UDP_conns = stats.max_UDP_conns;
 	s.max_ICMP_conns = stats.max_ICMP_conns;
 	s.max_fragments = stats.max_fragments;
+
+	flow_bypass.GetStats(&s.bypass);
 	}
 
 Connection* NetSessions::NewConn(const ConnIDKey& k, double t, const ConnID* id,
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "Frag.h"
+#include "FlowBypass.h"
 #include "PacketFilter.h"
 #include "NetVar.h"
 #include "analyzer/protocol/tcp/Stats.h"
@@ -41,6 +42,8 @@ struct SessionStats {
 	size_t num_fragments;
 	size_t max_fragments;
 	uint64_t num_packets;
+
+	FlowBypass::Stats bypass;
 };
 
 class NetSessions {
@@ -66,6 +69,12 @@ public:
 	void Remove(Connection* c);
 	void Remove(FragReassembler* f);
 
+	// Skips all further packets of the connection right on arrival.
+	// The connection itself stays around until it times out.  Returns
+	// false if it's neither TCP nor UDP, or if the maximum number of
+	// bypassed flows is reached.
+	bool Bypass(Connection* c);
+
 	void Insert(Connection* c);
 
 	// Generating connection_pending events for all connections
@@ -234,6 +243,8 @@ protected:
 	analyzer::stepping_stone::SteppingStoneManager* stp_manager;
 	Discarder* discarder;
 	PacketFilter* packet_filter;
+	FlowBypass flow_bypass;
+	uint64_t bypass_after_bytes;
 	uint64_t num_packets_processed;
 	PacketProfiler* pkt_profiler;
 	bool dump_this_packet;	// if true, current packet should be recorded
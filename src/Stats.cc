@@ -15,6 +15,9 @@
 #include "input.h"
 
 uint64_t killed_by_inactivity = 0;
+uint64_t stats_only_tcp_conns = 0;
+uint64_t conn_val_updates = 0;
+uint64_t conn_val_updates_skipped = 0;
 
 uint64_t tot_ack_events = 0;
 uint64_t tot_ack_bytes = 0;
@@ -193,7 +196,9 @@ void ProfileLogger::Log()
 	trigger::Manager::Stats tstats;
 	trigger_mgr->GetStats(&tstats);
 
-	file->Write(fmt("%.06f Triggers: total=%lu pending=%lu\n", network_time, tstats.total, tstats.pending));
+	file->Write(fmt("%.06f Triggers: total=%lu pending=%lu coalesced=%lu evaluations=%lu fired=%lu timeouts=%lu\n",
+					network_time, tstats.total, tstats.pending, tstats.coalesced,
+					tstats.evaluations, tstats.fired, tstats.timeouts));
 
 	unsigned int* current_timers = TimerMgr::CurrentTimers();
 	for ( int i = 0; i < NUM_TIMER_TYPES; ++i )
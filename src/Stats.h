@@ -108,6 +108,9 @@ extern SampleLogger* sample_logger;
 
 // Connection statistics.
 extern uint64_t killed_by_inactivity;
+extern uint64_t stats_only_tcp_conns;
+extern uint64_t conn_val_updates;
+extern uint64_t conn_val_updates_skipped;
 
 // Content gap statistics.
 extern uint64_t tot_ack_events;
@@ -2,6 +2,8 @@
 
 #include "zeek-config.h"
 
+#include <algorithm>
+
 #include "CompHash.h"
 #include "Expr.h"
 #include "Event.h"
@@ -16,6 +18,7 @@
 #include "Debug.h"
 #include "Traverse.h"
 #include "Trigger.h"
+#include "Reduce.h"
 #include "IntrusivePtr.h"
 #include "logging/Manager.h"
 #include "logging/logging.bif.h"
@@ -94,6 +97,11 @@ void Stmt::Describe(ODesc* d) const
 		AddTag(d);
 	}
 
+IntrusivePtr<Stmt> Stmt::Reduce(Reducer* /* r */)
+	{
+	return {NewRef{}, this};
+	}
+
 void Stmt::DecrBPCount()
 	{
 	if ( breakpoint_count )
@@ -166,6 +174,12 @@ void ExprListStmt::Describe(ODesc* d) const
 	DescribeDone(d);
 	}
 
+IntrusivePtr<Stmt> ExprListStmt::Reduce(Reducer* r)
+	{
+	l->Reduce(r);
+	return {NewRef{}, this};
+	}
+
 TraversalCode ExprListStmt::Traverse(TraversalCallback* cb) const
 	{
 	TraversalCode tc = cb->PreStmt(this);
@@ -346,6 +360,14 @@ void ExprStmt::Describe(ODesc* d) const
 		DescribeDone(d);
 	}
 
+IntrusivePtr<Stmt> ExprStmt::Reduce(Reducer* r)
+	{
+	if ( e )
+		e = e->Reduce(r);
+
+	return {NewRef{}, this};
+	}
+
 TraversalCode ExprStmt::Traverse(TraversalCallback* cb) const
 	{
 	TraversalCode tc = cb->PreStmt(this);
@@ -425,6 +447,19 @@ void IfStmt::Describe(ODesc* d) const
 		s2->Describe(d);
 	}
 
+IntrusivePtr<Stmt> IfStmt::Reduce(Reducer* r)
+	{
+	e = e->Reduce(r);
+	s1 = s1->Reduce(r);
+	s2 = s2->Reduce(r);
+
+	if ( ! e->IsConst() )
+		return {NewRef{}, this};
+
+	r->RemovedBranch();
+	return e->ExprVal()->IsZero() ? s2 : s1;
+	}
+
 TraversalCode IfStmt::Traverse(TraversalCallback* cb) const
 	{
 	TraversalCode tc = cb->PreStmt(this);
@@ -551,6 +586,11 @@ void Case::Describe(ODesc* d) const
 	d->PopIndent();
 	}
 
+void Case::Reduce(Reducer* r)
+	{
+	s = s->Reduce(r);
+	}
+
 TraversalCode Case::Traverse(TraversalCallback* cb) const
 	{
 	TraversalCode tc;
@@ -864,6 +904,17 @@ void SwitchStmt::Describe(ODesc* d) const
 	d->NL();
 	}
 
+IntrusivePtr<Stmt> SwitchStmt::Reduce(Reducer* r)
+	{
+	// The case labels are constants already, and hashed.
+	ExprStmt::Reduce(r);
+
+	for ( const auto& c : *cases )
+		c->Reduce(r);
+
+	return {NewRef{}, this};
+	}
+
 TraversalCode SwitchStmt::Traverse(TraversalCallback* cb) const
 	{
 	TraversalCode tc = cb->PreStmt(this);
@@ -1017,6 +1068,20 @@ void WhileStmt::Describe(ODesc* d) const
 	d->PopIndent();
 	}
 
+IntrusivePtr<Stmt> WhileStmt::Reduce(Reducer* r)
+	{
+	loop_condition = loop_condition->Reduce(r);
+	body = body->Reduce(r);
+
+	if ( loop_condition->IsConst() && loop_condition->ExprVal()->IsZero() )
+		{
+		r->RemovedBranch();
+		return make_intrusive<NullStmt>();
+		}
+
+	return {NewRef{}, this};
+	}
+
 TraversalCode WhileStmt::Traverse(TraversalCallback* cb) const
 	{
 	TraversalCode tc = cb->PreStmt(this);
@@ -1309,6 +1374,13 @@ void ForStmt::Describe(ODesc* d) const
 	d->PopIndent();
 	}
 
+IntrusivePtr<Stmt> ForStmt::Reduce(Reducer* r)
+	{
+	ExprStmt::Reduce(r);
+	body = body->Reduce(r);
+	return {NewRef{}, this};
+	}
+
 TraversalCode ForStmt::Traverse(TraversalCallback* cb) const
 	{
 	TraversalCode tc = cb->PreStmt(this);
@@ -1558,6 +1630,38 @@ void StmtList::Describe(ODesc* d) const
 		}
 	}
 
+IntrusivePtr<Stmt> StmtList::Reduce(Reducer* r)
+	{
+	for ( int i = 0; i < stmts.length(); )
+		{
+		Stmt* s = stmts[i];
+		auto reduced = s->Reduce(r);
+
+		// A block doesn't start a new scope, so a nested one with a
+		// single statement can just as well be that statement.
+		if ( reduced->Tag() == STMT_LIST &&
+		     reduced->AsStmtList()->Stmts().length() == 1 )
+			reduced = {NewRef{}, reduced->AsStmtList()->Stmts()[0]};
+
+		if ( reduced->Tag() == STMT_NULL )
+			{
+			stmts.remove_nth(i);
+			Unref(s);
+			continue;
+			}
+
+		if ( reduced.get() != s )
+			{
+			stmts.replace(i, reduced.release());
+			Unref(s);
+			}
+
+		++i;
+		}
+
+	return {NewRef{}, this};
+	}
+
 TraversalCode StmtList::Traverse(TraversalCallback* cb) const
 	{
 	TraversalCode tc = cb->PreStmt(this);
@@ -1739,6 +1843,30 @@ TraversalCode NullStmt::Traverse(TraversalCallback* cb) const
 	HANDLE_TC_STMT_POST(tc);
 	}
 
+// Collects the frame offsets of all the locals referenced by a "when"
+// statement, including those in nested lambdas and "when"s.
+class WhenSlotCollector : public TraversalCallback {
+public:
+	WhenSlotCollector(std::vector<int>* arg_slots)
+		{ slots = arg_slots; }
+
+	TraversalCode PreExpr(const Expr* expr) override
+		{
+		if ( expr->Tag() == EXPR_NAME )
+			{
+			const ID* id = static_cast<const NameExpr*>(expr)->Id();
+
+			if ( ! id->IsGlobal() && ! id->AsType() )
+				slots->push_back(id->Offset());
+			}
+
+		return TC_CONTINUE;
+		}
+
+private:
+	std::vector<int>* slots;
+};
+
 WhenStmt::WhenStmt(IntrusivePtr<Expr> arg_cond,
                    IntrusivePtr<Stmt> arg_s1, IntrusivePtr<Stmt> arg_s2,
                    IntrusivePtr<Expr> arg_timeout, bool arg_is_return)
@@ -1761,6 +1889,13 @@ WhenStmt::WhenStmt(IntrusivePtr<Expr> arg_cond,
 		if ( bt != TYPE_TIME && bt != TYPE_INTERVAL )
 			cond->Error("when timeout requires a time or time interval");
 		}
+
+	WhenSlotCollector cb(&frame_slots);
+	Traverse(&cb);
+
+	std::sort(frame_slots.begin(), frame_slots.end());
+	frame_slots.erase(std::unique(frame_slots.begin(), frame_slots.end()),
+	                  frame_slots.end());
 	}
 
 WhenStmt::~WhenStmt() = default;
@@ -1775,7 +1910,7 @@ IntrusivePtr<Val> WhenStmt::Exec(Frame* f, stmt_flow_type& flow) const
 	                     IntrusivePtr{s1}.release(),
 	                     IntrusivePtr{s2}.release(),
 	                     IntrusivePtr{timeout}.release(),
-	                     f, is_return, location);
+	                     f, is_return, location, &frame_slots);
 	return nullptr;
 	}
 
@@ -1832,6 +1967,12 @@ TraversalCode WhenStmt::Traverse(TraversalCallback* cb) const
 	tc = s1->Traverse(cb);
 	HANDLE_TC_STMT_PRE(tc);
 
+	if ( timeout )
+		{
+		tc = timeout->Traverse(cb);
+		HANDLE_TC_STMT_PRE(tc);
+		}
+
 	if ( s2 )
 		{
 		tc = s2->Traverse(cb);
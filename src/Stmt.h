@@ -4,10 +4,13 @@
 
 // BRO statements.
 
+#include <vector>
+
 #include "BroList.h"
 #include "Dict.h"
 #include "ID.h"
 #include "Obj.h"
+#include "ScriptProfiler.h"
 
 #include "StmtEnums.h"
 
@@ -19,6 +22,7 @@ class EventExpr;
 class ListExpr;
 class ForStmt;
 class Frame;
+class Reducer;
 
 class Stmt : public BroObj {
 public:
@@ -55,7 +59,15 @@ public:
 		return (ForStmt*) this;
 		}
 
-	void RegisterAccess() const	{ last_access = network_time; access_count++; }
+	void RegisterAccess() const
+		{
+		last_access = network_time;
+		access_count++;
+
+		if ( ScriptProfiler::SamplePending() )
+			script_profiler.Sample(this);
+		}
+
 	void AccessStats(ODesc* d) const;
 	uint32_t GetAccessCount() const { return access_count; }
 
@@ -66,6 +78,12 @@ public:
 
 	virtual unsigned int BPCount() const	{ return breakpoint_count; }
 
+	// Returns an equivalent statement that's cheaper to execute, e.g.
+	// the branch that a constant condition selects, after reducing the
+	// statement's expressions and sub-statements in place.  See
+	// Reducer for the details.  The default leaves the statement as it is.
+	virtual IntrusivePtr<Stmt> Reduce(Reducer* r);
+
 	virtual TraversalCode Traverse(TraversalCallback* cb) const = 0;
 
 protected:
@@ -87,6 +105,8 @@ class ExprListStmt : public Stmt {
 public:
 	const ListExpr* ExprList() const	{ return l.get(); }
 
+	IntrusivePtr<Stmt> Reduce(Reducer* r) override;
+
 	TraversalCode Traverse(TraversalCallback* cb) const override;
 
 protected:
@@ -124,6 +144,8 @@ public:
 
 	void Describe(ODesc* d) const override;
 
+	IntrusivePtr<Stmt> Reduce(Reducer* r) override;
+
 	TraversalCode Traverse(TraversalCallback* cb) const override;
 
 protected:
@@ -146,6 +168,8 @@ public:
 
 	void Describe(ODesc* d) const override;
 
+	IntrusivePtr<Stmt> Reduce(Reducer* r) override;
+
 	TraversalCode Traverse(TraversalCallback* cb) const override;
 
 protected:
@@ -172,6 +196,9 @@ public:
 
 	void Describe(ODesc* d) const override;
 
+	// Reduces the case's body, see Stmt::Reduce().
+	void Reduce(Reducer* r);
+
 	TraversalCode Traverse(TraversalCallback* cb) const;
 
 protected:
@@ -191,6 +218,8 @@ public:
 
 	void Describe(ODesc* d) const override;
 
+	IntrusivePtr<Stmt> Reduce(Reducer* r) override;
+
 	TraversalCode Traverse(TraversalCallback* cb) const override;
 
 protected:
@@ -265,6 +294,8 @@ public:
 
 	void Describe(ODesc* d) const override;
 
+	IntrusivePtr<Stmt> Reduce(Reducer* r) override;
+
 	TraversalCode Traverse(TraversalCallback* cb) const override;
 
 protected:
@@ -291,6 +322,8 @@ public:
 
 	void Describe(ODesc* d) const override;
 
+	IntrusivePtr<Stmt> Reduce(Reducer* r) override;
+
 	TraversalCode Traverse(TraversalCallback* cb) const override;
 
 protected:
@@ -366,6 +399,8 @@ public:
 
 	void Describe(ODesc* d) const override;
 
+	IntrusivePtr<Stmt> Reduce(Reducer* r) override;
+
 	TraversalCode Traverse(TraversalCallback* cb) const override;
 
 protected:
@@ -447,4 +482,8 @@ protected:
 	IntrusivePtr<Stmt> s2;
 	IntrusivePtr<Expr> timeout;
 	bool is_return;
+
+	// Frame offsets of the locals the statement refers to, which are
+	// all that its trigger needs to keep of the frame.
+	std::vector<int> frame_slots;
 };
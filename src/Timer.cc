@@ -34,6 +34,7 @@ const char* TimerNames[] = {
 	"RemoveConnection",
 	"RPCExpireTimer",
 	"ScheduleTimer",
+	"TableSyncTimer",
 	"TableValTimer",
 	"TCPConnectionAttemptTimer",
 	"TCPConnectionDeleteTimer",
@@ -30,6 +30,7 @@ enum TimerType : uint8_t {
 	TIMER_REMOVE_CONNECTION,
 	TIMER_RPC_EXPIRE,
 	TIMER_SCHEDULE,
+	TIMER_TABLE_SYNC,
 	TIMER_TABLE_VAL,
 	TIMER_TCP_ATTEMPT,
 	TIMER_TCP_DELETE,
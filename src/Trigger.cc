@@ -1,12 +1,14 @@
 #include "Trigger.h"
 
 #include <algorithm>
+#include <unordered_set>
 
 #include <assert.h>
 
 #include "Traverse.h"
 #include "Expr.h"
 #include "Frame.h"
+#include "Hash.h"
 #include "ID.h"
 #include "Val.h"
 #include "Stmt.h"
@@ -33,7 +35,18 @@ public:
 	virtual TraversalCode PreExpr(const Expr*);
 
 private:
+	// If table_expr refers to a global table, registers for changes
+	// of just the element that index_expr currently evaluates to,
+	// rather than for any change of the table.
+	void RegisterElement(const Expr* table_expr, const Expr* index_expr);
+
 	Trigger* trigger;
+
+	// The table expressions (NameExprs of global tables) of index
+	// operations for which only the indexed element has been
+	// registered, so that PreExpr() skips registering the whole table
+	// when the traversal reaches them.
+	std::unordered_set<const Expr*> element_tables;
 };
 
 }
@@ -50,12 +63,22 @@ TraversalCode TriggerTraversalCallback::PreExpr(const Expr* expr)
 		if ( e->Id()->IsGlobal() )
 			trigger->Register(e->Id());
 
+		if ( element_tables.count(e) )
+			break;
+
 		Val* v = e->Id()->ID_Val();
 		if ( v && v->Modifiable() )
 			trigger->Register(v);
 		break;
 		};
 
+	case EXPR_IN:
+		{
+		const InExpr* e = static_cast<const InExpr*>(expr);
+		RegisterElement(e->Op2(), e->Op1());
+		break;
+		}
+
 	case EXPR_INDEX:
 		{
 		const IndexExpr* e = static_cast<const IndexExpr*>(expr);
@@ -71,6 +94,7 @@ TraversalCode TriggerTraversalCallback::PreExpr(const Expr* expr)
 		catch ( InterpreterException& )
 			{ /* Already reported */ }
 
+		RegisterElement(e->Op1(), e->Op2());
 		break;
 		}
 
@@ -82,6 +106,45 @@ TraversalCode TriggerTraversalCallback::PreExpr(const Expr* expr)
 	return TC_CONTINUE;
 	}
 
+void TriggerTraversalCallback::RegisterElement(const Expr* table_expr,
+                                               const Expr* index_expr)
+	{
+	if ( table_expr->Tag() != EXPR_NAME )
+		return;
+
+	ID* id = static_cast<const NameExpr*>(table_expr)->Id();
+	Val* t = id->IsGlobal() ? id->ID_Val() : nullptr;
+
+	// Lookups in subnet tables don't need an exact match, so they
+	// depend on all elements.
+	if ( ! t || t->Type()->Tag() != TYPE_TABLE || t->AsTableVal()->Subnets() )
+		return;
+
+	IntrusivePtr<Val> index;
+	BroObj::SuppressErrors no_errors;
+
+	try
+		{
+		index = index_expr->Eval(trigger->frame);
+		}
+	catch ( InterpreterException& )
+		{ /* Already reported */ }
+
+	if ( ! index )
+		return;
+
+	// Fails if the index doesn't match the table's type, e.g. for
+	// pattern tables looked up by string.
+	HashKey* k = t->AsTableVal()->ComputeHash(index.get());
+
+	if ( ! k )
+		return;
+
+	trigger->Register(t, k);
+	element_tables.insert(table_expr);
+	delete k;
+	}
+
 namespace trigger {
 
 class TriggerTimer final : public Timer {
@@ -123,13 +186,14 @@ protected:
 
 Trigger::Trigger(Expr* arg_cond, Stmt* arg_body, Stmt* arg_timeout_stmts,
 			Expr* arg_timeout, Frame* arg_frame,
-			bool arg_is_return, const Location* arg_location)
+			bool arg_is_return, const Location* arg_location,
+			const std::vector<int>* slots)
 	{
 	cond = arg_cond;
 	body = arg_body;
 	timeout_stmts = arg_timeout_stmts;
 	timeout = arg_timeout;
-	frame = arg_frame->Clone();
+	frame = slots ? arg_frame->CloneSlots(*slots) : arg_frame->Clone();
 	timer = nullptr;
 	delayed = false;
 	disabled = false;
@@ -268,6 +332,7 @@ bool Trigger::Eval()
 	f->SetTrigger({NewRef{}, this});
 
 	IntrusivePtr<Val> v;
+	++trigger_mgr->evaluations;
 
 	try
 		{
@@ -300,6 +365,7 @@ bool Trigger::Eval()
 
 	v = nullptr;
 	stmt_flow_type flow;
+	++trigger_mgr->fired;
 
 	try
 		{
@@ -351,6 +417,7 @@ void Trigger::Timeout()
 	if ( timeout_stmts )
 		{
 		stmt_flow_type flow;
+		++trigger_mgr->timeouts;
 		IntrusivePtr<Frame> f{AdoptRef{}, frame->Clone()};
 		IntrusivePtr<Val> v;
 
@@ -409,6 +476,19 @@ void Trigger::Register(Val* val)
 	objs.emplace_back(val, val->Modifiable());
 	}
 
+void Trigger::Register(Val* val, const HashKey* k)
+	{
+	if ( ! val->Modifiable() )
+		return;
+
+	assert(! disabled);
+	std::string key(static_cast<const char*>(k->Key()), k->Size());
+	notifier::registry.Register(val->Modifiable(), this, key);
+
+	Ref(val);
+	element_objs.emplace_back(val, std::move(key));
+	}
+
 void Trigger::UnregisterAll()
 	{
 	DBG_LOG(DBG_NOTIFIERS, "%s: unregistering all", Name());
@@ -420,6 +500,14 @@ void Trigger::UnregisterAll()
 		}
 
 	objs.clear();
+
+	for ( const auto& o : element_objs )
+		{
+		notifier::registry.Unregister(o.first->Modifiable(), this, o.second);
+		Unref(o.first);
+		}
+
+	element_objs.clear();
 	}
 
 void Trigger::Attach(Trigger *trigger)
@@ -526,7 +614,10 @@ void Manager::Process()
 	for ( TriggerList::iterator i = orig->begin(); i != orig->end(); ++i )
 		{
 		Trigger* t = *i;
-		(*i)->Eval();
+
+		// From here on, modifications need another evaluation.
+		t->queued = false;
+		t->Eval();
 		Unref(t);
 		}
 
@@ -538,17 +629,27 @@ void Manager::Process()
 
 void Manager::Queue(Trigger* trigger)
 	{
-	if ( std::find(pending->begin(), pending->end(), trigger) == pending->end() )
+	// Any number of modifications before the next round of processing
+	// result in a single evaluation.
+	if ( trigger->queued )
 		{
-		Ref(trigger);
-		pending->push_back(trigger);
-		total_triggers++;
-		iosource_mgr->Wakeup(Tag());
+		++coalesced;
+		return;
 		}
+
+	Ref(trigger);
+	trigger->queued = true;
+	pending->push_back(trigger);
+	total_triggers++;
+	iosource_mgr->Wakeup(Tag());
 	}
 
 void Manager::GetStats(Stats* stats)
 	{
 	stats->total = total_triggers;
 	stats->pending = pending->size();
+	stats->coalesced = coalesced;
+	stats->evaluations = evaluations;
+	stats->fired = fired;
+	stats->timeouts = timeouts;
 	}
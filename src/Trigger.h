@@ -7,6 +7,7 @@
 #include <list>
 #include <vector>
 #include <map>
+#include <string>
 
 class CallExpr;
 class Expr;
@@ -15,6 +16,7 @@ class Frame;
 class Val;
 class ID;
 class ODesc;
+class HashKey;
 
 namespace trigger {
 // Triggers are the heart of "when" statements: expressions that when
@@ -22,15 +24,18 @@ namespace trigger {
 
 class TriggerTimer;
 class TriggerTraversalCallback;
+class Manager;
 
 class Trigger final : public BroObj, public notifier::Receiver {
 public:
 	// Don't access Trigger objects; they take care of themselves after
 	// instantiation.  Note that if the condition is already true, the
 	// statements are executed immediately and the object is deleted
-	// right away.
+	// right away.  If slots is given, only the values of the frame in
+	// those slots are kept, rather than copying the whole frame.
 	Trigger(Expr* cond, Stmt* body, Stmt* timeout_stmts, Expr* timeout,
-		Frame* f, bool is_return, const Location* loc);
+		Frame* f, bool is_return, const Location* loc,
+		const std::vector<int>* slots = nullptr);
 	~Trigger() override;
 
 	// Evaluates the condition. If true, executes the body and deletes
@@ -85,10 +90,12 @@ public:
 private:
 	friend class TriggerTraversalCallback;
 	friend class TriggerTimer;
+	friend class Manager;
 
 	void Init();
 	void Register(ID* id);
 	void Register(Val* val);
+	void Register(Val* val, const HashKey* k);
 	void UnregisterAll();
 
 	Expr* cond;
@@ -105,9 +112,14 @@ private:
 
 	bool delayed; // true if a function call is currently being delayed
 	bool disabled;
+	bool queued = false; // true while waiting in the manager's pending list
 
 	std::vector<std::pair<BroObj *, notifier::Modifiable*>> objs;
 
+	// Values registered for changes of a single element, with the
+	// element's key.
+	std::vector<std::pair<Val*, std::string>> element_objs;
+
 	using ValCache = std::map<const CallExpr*, Val*>;
 	ValCache cache;
 };
@@ -125,17 +137,26 @@ public:
 	void Queue(Trigger* trigger);
 
 	struct Stats {
-		unsigned long total;
-		unsigned long pending;
+		unsigned long total;	// triggers queued for evaluation
+		unsigned long pending;	// triggers currently queued
+		unsigned long coalesced;	// notifications for already queued triggers
+		unsigned long evaluations;	// conditions evaluated
+		unsigned long fired;	// bodies executed
+		unsigned long timeouts;	// timeout bodies executed
 	};
 
 	void GetStats(Stats* stats);
 
 private:
+	friend class Trigger;
 
 	using TriggerList = std::list<Trigger*>;
 	TriggerList* pending;
 	unsigned long total_triggers = 0;
+	unsigned long coalesced = 0;
+	unsigned long evaluations = 0;
+	unsigned long fired = 0;
+	unsigned long timeouts = 0;
 	};
 
 }
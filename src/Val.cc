@@ -150,6 +150,12 @@ IntrusivePtr<Val> Val::DoClone(CloneState* state)
 	return nullptr;
  	}
 
+const val_list* Val::AsRecord() const
+	{
+	CHECK_TAG(type->Tag(), TYPE_RECORD, "Val::AsRecord", type_name)
+	return static_cast<const RecordVal*>(this)->FieldList();
+	}
+
 bool Val::IsZero() const
 	{
 	switch ( type->InternalType() ) {
@@ -1415,6 +1421,19 @@ TableVal::~TableVal()
 
 void TableVal::RemoveAll()
 	{
+	if ( element_observer )
+		{
+		const PDict<TableEntryVal>* tbl = AsTable();
+		IterCookie* c = tbl->InitForIteration();
+		HashKey* k;
+
+		while ( tbl->NextEntry(k, c) )
+			{
+			element_observer->ElementModified(this, k, true);
+			delete k;
+			}
+		}
+
 	// Here we take the brute force approach.
 	delete AsTable();
 	val.table_val = new PDict<TableEntryVal>;
@@ -1545,7 +1564,10 @@ bool TableVal::Assign(Val* index, HashKey* k, IntrusivePtr<Val> new_val)
 	if ( old_entry_val && attrs && attrs->FindAttr(ATTR_EXPIRE_CREATE) )
 		new_entry_val->SetExpireAccess(old_entry_val->ExpireAccessTime());
 
-	Modified();
+	Modified(k_copy.Key(), k_copy.Size());
+
+	if ( element_observer )
+		element_observer->ElementModified(this, &k_copy, false);
 
 	if ( change_func )
 		{
@@ -2061,11 +2083,17 @@ IntrusivePtr<Val> TableVal::Delete(const Val* index)
 	if ( subnets && ! subnets->Remove(index) )
 		reporter->InternalWarning("index not in prefix table");
 
+	if ( element_observer && v )
+		element_observer->ElementModified(this, k, true);
+
+	if ( k )
+		Modified(k->Key(), k->Size());
+	else
+		Modified();
+
 	delete k;
 	delete v;
 
-	Modified();
-
 	if ( change_func )
 		CallChangeFunc(index, va.get(), ELEMENT_REMOVED);
 
@@ -2087,7 +2115,10 @@ IntrusivePtr<Val> TableVal::Delete(const HashKey* k)
 
 	delete v;
 
-	Modified();
+	Modified(k->Key(), k->Size());
+
+	if ( element_observer && va )
+		element_observer->ElementModified(this, k, true);
 
 	if ( change_func && va )
 		{
@@ -2633,7 +2664,8 @@ RecordVal::RecordVal(RecordType* t, bool init_fields) : Val(t)
 	{
 	origin = nullptr;
 	int n = t->NumFields();
-	val_list* vl = val.val_list_val = new val_list(n);
+	slots.resize(n);
+	states.resize(n, SLOT_UNSET);
 
 	if ( is_parsing )
 		parse_time_records[t].emplace_back(NewRef{}, this);
@@ -2675,13 +2707,34 @@ RecordVal::RecordVal(RecordType* t, bool init_fields) : Val(t)
 				def = make_intrusive<VectorVal>(type->AsVectorType());
 			}
 
-		vl->push_back(def.release());
+		if ( def && ! AssignInline(i, def.get()) )
+			{
+			slots[i].val = def.release();
+			states[i] = SLOT_VAL;
+			}
 		}
 	}
 
 RecordVal::~RecordVal()
 	{
-	delete_vals(AsNonConstRecord());
+	for ( size_t i = 0; i < slots.size(); ++i )
+		if ( states[i] == SLOT_VAL )
+			Unref(slots[i].val);
+
+	delete field_list;
+	}
+
+const val_list* RecordVal::FieldList() const
+	{
+	if ( ! field_list )
+		field_list = new val_list(slots.size());
+	else
+		field_list->clear();
+
+	for ( size_t i = 0; i < slots.size(); ++i )
+		field_list->push_back(Lookup(i));
+
+	return field_list;
 	}
 
 IntrusivePtr<Val> RecordVal::SizeVal() const
@@ -2689,26 +2742,284 @@ IntrusivePtr<Val> RecordVal::SizeVal() const
 	return val_mgr->Count(Type()->AsRecordType()->NumFields());
 	}
 
+InternalTypeTag RecordVal::InlineType(int field) const
+	{
+	auto it = Type()->AsRecordType()->FieldType(field)->InternalType();
+
+	switch ( it ) {
+	case TYPE_INTERNAL_INT:
+	case TYPE_INTERNAL_UNSIGNED:
+	case TYPE_INTERNAL_DOUBLE:
+	case TYPE_INTERNAL_ADDR:
+		return it;
+
+	default:
+		return TYPE_INTERNAL_VOID;
+	}
+	}
+
+bool RecordVal::AssignInline(int field, Val* v)
+	{
+	BroType* ft = Type()->AsRecordType()->FieldType(field);
+	InternalTypeTag it = InlineType(field);
+
+	if ( it == TYPE_INTERNAL_VOID || v->Type()->Tag() != ft->Tag() )
+		return false;
+
+	// MakeVal() needs to be able to recreate an equivalent Val.
+	if ( ft->Tag() == TYPE_ENUM && v->Type() != ft )
+		return false;
+
+	if ( ft->Tag() == TYPE_INTERVAL && dynamic_cast<IntervalVal*>(v) )
+		return false;
+
+	FieldSlot s;
+
+	switch ( it ) {
+	case TYPE_INTERNAL_INT:
+		s.int_val = v->InternalInt();
+		break;
+
+	case TYPE_INTERNAL_UNSIGNED:
+		s.uint_val = v->InternalUnsigned();
+		break;
+
+	case TYPE_INTERNAL_DOUBLE:
+		s.double_val = v->InternalDouble();
+		break;
+
+	case TYPE_INTERNAL_ADDR:
+		v->AsAddr().CopyIPv6(s.addr_val, IPAddr::Network);
+		break;
+
+	default:
+		return false;
+	}
+
+	SetInline(field, s);
+	return true;
+	}
+
+Val* RecordVal::MakeVal(int field) const
+	{
+	BroType* ft = Type()->AsRecordType()->FieldType(field);
+	const FieldSlot& s = slots[field];
+	IntrusivePtr<Val> v;
+
+	switch ( ft->Tag() ) {
+	case TYPE_BOOL:
+		v = val_mgr->Bool(s.int_val);
+		break;
+
+	case TYPE_INT:
+		v = val_mgr->Int(s.int_val);
+		break;
+
+	case TYPE_ENUM:
+		v = ft->AsEnumType()->GetVal(s.int_val);
+		break;
+
+	case TYPE_COUNT:
+		v = val_mgr->Count(s.uint_val);
+		break;
+
+	case TYPE_PORT:
+		v = val_mgr->Port(s.uint_val);
+		break;
+
+	case TYPE_COUNTER:
+		v = IntrusivePtr<Val>{AdoptRef{}, new Val(s.uint_val, TYPE_COUNTER)};
+		break;
+
+	case TYPE_DOUBLE:
+	case TYPE_TIME:
+	case TYPE_INTERVAL:
+		v = make_intrusive<Val>(s.double_val, ft->Tag());
+		break;
+
+	case TYPE_ADDR:
+		v = make_intrusive<AddrVal>(s.addr_val);
+		break;
+
+	default:
+		reporter->InternalError("bad type for inline record field");
+	}
+
+	slots[field].val = v.release();
+	states[field] = SLOT_VAL;
+	return slots[field].val;
+	}
+
+void RecordVal::ClearField(int field)
+	{
+	if ( states[field] == SLOT_VAL )
+		Unref(slots[field].val);
+
+	states[field] = SLOT_UNSET;
+	}
+
+void RecordVal::SetInline(int field, const FieldSlot& s)
+	{
+	ClearField(field);
+	slots[field] = s;
+	states[field] = SLOT_INLINE;
+	}
+
 void RecordVal::Assign(int field, IntrusivePtr<Val> new_val)
 	{
-	Val* old_val = AsNonConstRecord()->replace(field, new_val.release());
-	Unref(old_val);
+	if ( ! new_val || ! AssignInline(field, new_val.get()) )
+		{
+		ClearField(field);
+
+		if ( new_val )
+			{
+			slots[field].val = new_val.release();
+			states[field] = SLOT_VAL;
+			}
+		}
+
 	Modified();
 	}
 
 void RecordVal::Assign(int field, Val* new_val)
 	{
-	Assign(field, {AdoptRef{}, new_val});
+	// Callers may keep using the pointer they passed in, so unless
+	// somebody else holds a reference, the Val needs to stay.
+	if ( new_val && new_val->RefCnt() > 1 && AssignInline(field, new_val) )
+		Unref(new_val);
+
+	else
+		{
+		ClearField(field);
+
+		if ( new_val )
+			{
+			slots[field].val = new_val;
+			states[field] = SLOT_VAL;
+			}
+		}
+
+	Modified();
+	}
+
+void RecordVal::AssignInt(int field, bro_int_t v)
+	{
+	if ( InlineType(field) != TYPE_INTERNAL_INT )
+		reporter->InternalError("bad type for RecordVal::AssignInt");
+
+	FieldSlot s;
+	s.int_val = v;
+	SetInline(field, s);
+	Modified();
+	}
+
+void RecordVal::AssignUnsigned(int field, bro_uint_t v)
+	{
+	auto tag = Type()->AsRecordType()->FieldType(field)->Tag();
+
+	if ( tag != TYPE_COUNT && tag != TYPE_COUNTER )
+		reporter->InternalError("bad type for RecordVal::AssignUnsigned");
+
+	FieldSlot s;
+	s.uint_val = v;
+	SetInline(field, s);
+	Modified();
+	}
+
+void RecordVal::AssignDouble(int field, double v)
+	{
+	if ( InlineType(field) != TYPE_INTERNAL_DOUBLE )
+		reporter->InternalError("bad type for RecordVal::AssignDouble");
+
+	FieldSlot s;
+	s.double_val = v;
+	SetInline(field, s);
+	Modified();
+	}
+
+void RecordVal::AssignAddr(int field, const IPAddr& v)
+	{
+	if ( InlineType(field) != TYPE_INTERNAL_ADDR )
+		reporter->InternalError("bad type for RecordVal::AssignAddr");
+
+	FieldSlot s;
+	v.CopyIPv6(s.addr_val, IPAddr::Network);
+	SetInline(field, s);
+	Modified();
+	}
+
+void RecordVal::AssignPort(int field, uint32_t port_num, TransportProto port_type)
+	{
+	if ( Type()->AsRecordType()->FieldType(field)->Tag() != TYPE_PORT )
+		reporter->InternalError("bad type for RecordVal::AssignPort");
+
+	FieldSlot s;
+	s.uint_val = PortVal::Mask(port_num, port_type);
+	SetInline(field, s);
+	Modified();
+	}
+
+bro_int_t RecordVal::FieldInt(int field) const
+	{
+	if ( states[field] == SLOT_INLINE )
+		return slots[field].int_val;
+
+	if ( states[field] == SLOT_UNSET )
+		reporter->InternalError("RecordVal::FieldInt of unset field");
+
+	return slots[field].val->InternalInt();
+	}
+
+bro_uint_t RecordVal::FieldUnsigned(int field) const
+	{
+	if ( states[field] == SLOT_INLINE )
+		return slots[field].uint_val;
+
+	if ( states[field] == SLOT_UNSET )
+		reporter->InternalError("RecordVal::FieldUnsigned of unset field");
+
+	return slots[field].val->InternalUnsigned();
+	}
+
+double RecordVal::FieldDouble(int field) const
+	{
+	if ( states[field] == SLOT_INLINE )
+		return slots[field].double_val;
+
+	if ( states[field] == SLOT_UNSET )
+		reporter->InternalError("RecordVal::FieldDouble of unset field");
+
+	return slots[field].val->InternalDouble();
+	}
+
+IPAddr RecordVal::FieldAddr(int field) const
+	{
+	if ( states[field] == SLOT_INLINE )
+		return IPAddr(IPv6, slots[field].addr_val, IPAddr::Network);
+
+	if ( states[field] == SLOT_UNSET )
+		reporter->InternalError("RecordVal::FieldAddr of unset field");
+
+	return slots[field].val->AsAddr();
 	}
 
 Val* RecordVal::Lookup(int field) const
 	{
-	return (*AsRecord())[field];
+	switch ( states[field] ) {
+	case SLOT_VAL:
+		return slots[field].val;
+
+	case SLOT_INLINE:
+		return MakeVal(field);
+
+	default:
+		return nullptr;
+	}
 	}
 
 IntrusivePtr<Val> RecordVal::LookupWithDefault(int field) const
 	{
-	Val* val = (*AsRecord())[field];
+	Val* val = Lookup(field);
 
 	if ( val )
 		return {NewRef{}, val};
@@ -2727,16 +3038,24 @@ void RecordVal::ResizeParseTimeRecords(RecordType* rt)
 
 	for ( auto& rv : rvs )
 		{
-		auto vs = rv->val.val_list_val;
-		auto current_length = vs->length();
+		int current_length = rv->slots.size();
 		auto required_length = rt->NumFields();
 
 		if ( required_length > current_length )
 			{
-			vs->resize(required_length);
+			rv->slots.resize(required_length);
+			rv->states.resize(required_length, SLOT_UNSET);
 
 			for ( auto i = current_length; i < required_length; ++i )
-				vs->replace(i, rt->FieldDefault(i).release());
+				{
+				auto def = rt->FieldDefault(i);
+
+				if ( def )
+					{
+					rv->slots[i].val = def.release();
+					rv->states[i] = SLOT_VAL;
+					}
+				}
 			}
 		}
 	}
@@ -2787,12 +3106,21 @@ IntrusivePtr<RecordVal> RecordVal::CoerceTo(const RecordType* t, Val* aggr, bool
 			break;
 			}
 
-		Val* v = Lookup(i);
-
-		if ( ! v )
+		if ( states[i] == SLOT_UNSET )
 			// Check for allowable optional fields is outside the loop, below.
 			continue;
 
+		if ( states[i] == SLOT_INLINE &&
+		     same_type(ar_t->FieldType(t_i), rv_t->FieldType(i)) )
+			{
+			// No need for a Val.
+			ar->SetInline(t_i, slots[i]);
+			ar->Modified();
+			continue;
+			}
+
+		Val* v = Lookup(i);
+
 		if ( ar_t->FieldType(t_i)->Tag() == TYPE_RECORD &&
 		     ! same_type(ar_t->FieldType(t_i), v->Type()) )
 			{
@@ -2807,7 +3135,7 @@ IntrusivePtr<RecordVal> RecordVal::CoerceTo(const RecordType* t, Val* aggr, bool
 		}
 
 	for ( i = 0; i < ar_t->NumFields(); ++i )
-		if ( ! ar->Lookup(i) &&
+		if ( ! ar->HasField(i) &&
 			 ! ar_t->FieldDecl(i)->FindAttr(ATTR_OPTIONAL) )
 			{
 			char buf[512];
@@ -2834,8 +3162,7 @@ IntrusivePtr<TableVal> RecordVal::GetRecordFieldsVal() const
 
 void RecordVal::Describe(ODesc* d) const
 	{
-	const val_list* vl = AsRecord();
-	int n = vl->length();
+	int n = slots.size();
 	auto record_type = Type()->AsRecordType();
 
 	if ( d->IsBinary() || d->IsPortable() )
@@ -2848,7 +3175,7 @@ void RecordVal::Describe(ODesc* d) const
 	else
 		d->Add("[");
 
-	loop_over_list(*vl, i)
+	for ( int i = 0; i < n; ++i )
 		{
 		if ( ! d->IsBinary() && i > 0 )
 			d->Add(", ");
@@ -2858,7 +3185,7 @@ void RecordVal::Describe(ODesc* d) const
 		if ( ! d->IsBinary() )
 			d->Add("=");
 
-		Val* v = (*vl)[i];
+		Val* v = Lookup(i);
 		if ( v )
 			v->Describe(d);
 		else
@@ -2871,14 +3198,13 @@ void RecordVal::Describe(ODesc* d) const
 
 void RecordVal::DescribeReST(ODesc* d) const
 	{
-	const val_list* vl = AsRecord();
-	int n = vl->length();
+	int n = slots.size();
 	auto record_type = Type()->AsRecordType();
 
 	d->Add("{");
 	d->PushIndent();
 
-	loop_over_list(*vl, i)
+	for ( int i = 0; i < n; ++i )
 		{
 		if ( i > 0 )
 			d->NL();
@@ -2886,7 +3212,7 @@ void RecordVal::DescribeReST(ODesc* d) const
 		d->Add(record_type->FieldName(i));
 		d->Add("=");
 
-		Val* v = (*vl)[i];
+		Val* v = Lookup(i);
 
 		if ( v )
 			v->Describe(d);
@@ -2909,10 +3235,18 @@ IntrusivePtr<Val> RecordVal::DoClone(CloneState* state)
 	rv->origin = nullptr;
 	state->NewClone(this, rv);
 
-	for ( const auto& vlv : *val.val_list_val )
+	for ( size_t i = 0; i < slots.size(); ++i )
 		{
-		auto v = vlv ? vlv->Clone(state) : nullptr;
-  		rv->val.val_list_val->push_back(v.release());
+		if ( states[i] == SLOT_VAL )
+			{
+			rv->slots[i].val = slots[i].val->Clone(state).release();
+			rv->states[i] = SLOT_VAL;
+			}
+		else
+			{
+			rv->slots[i] = slots[i];
+			rv->states[i] = states[i];
+			}
 		}
 
 	return rv;
@@ -2921,15 +3255,16 @@ IntrusivePtr<Val> RecordVal::DoClone(CloneState* state)
 unsigned int RecordVal::MemoryAllocation() const
 	{
 	unsigned int size = 0;
-	const val_list* vl = AsRecord();
 
-	for ( const auto& v : *vl )
+	for ( size_t i = 0; i < slots.size(); ++i )
 		{
-		if ( v )
-		    size += v->MemoryAllocation();
+		if ( states[i] == SLOT_VAL )
+		    size += slots[i].val->MemoryAllocation();
 		}
 
-	return size + padded_sizeof(*this) + val.val_list_val->MemoryAllocation();
+	return size + padded_sizeof(*this) +
+		pad_size(slots.capacity() * sizeof(FieldSlot)) +
+		pad_size(states.capacity() * sizeof(SlotState));
 	}
 
 IntrusivePtr<Val> EnumVal::SizeVal() const
@@ -80,7 +80,6 @@ union BroValUnion {
 	BroFile* file_val;
 	RE_Matcher* re_val;
 	PDict<TableEntryVal>* table_val;
-	val_list* val_list_val;
 
 	std::vector<Val*>* vector_val;
 
@@ -116,9 +115,6 @@ union BroValUnion {
 	constexpr BroValUnion(PDict<TableEntryVal>* value) noexcept
 		: table_val(value) {}
 
-	constexpr BroValUnion(val_list* value) noexcept
-		: val_list_val(value) {}
-
 	constexpr BroValUnion(std::vector<Val*> *value) noexcept
 		: vector_val(value) {}
 };
@@ -208,11 +204,13 @@ public:
 	CONST_ACCESSOR(TYPE_STRING, BroString*, string_val, AsString)
 	CONST_ACCESSOR(TYPE_FUNC, Func*, func_val, AsFunc)
 	CONST_ACCESSOR(TYPE_TABLE, PDict<TableEntryVal>*, table_val, AsTable)
-	CONST_ACCESSOR(TYPE_RECORD, val_list*, val_list_val, AsRecord)
 	CONST_ACCESSOR(TYPE_FILE, BroFile*, file_val, AsFile)
 	CONST_ACCESSOR(TYPE_PATTERN, RE_Matcher*, re_val, AsPattern)
 	CONST_ACCESSOR(TYPE_VECTOR, std::vector<Val*>*, vector_val, AsVector)
 
+	[[deprecated("Remove in v4.1.  Use RecordVal::Lookup() instead.")]]
+	const val_list* AsRecord() const;
+
 	const IPPrefix& AsSubNet() const
 		{
 		CHECK_TAG(type->Tag(), TYPE_SUBNET, "Val::SubNet", type_name)
@@ -357,7 +355,6 @@ protected:
 		}
 
 	ACCESSOR(TYPE_TABLE, PDict<TableEntryVal>*, table_val, AsNonConstTable)
-	ACCESSOR(TYPE_RECORD, val_list*, val_list_val, AsNonConstRecord)
 
 	// For internal use by the Val::Clone() methods.
 	struct CloneState {
@@ -712,6 +709,20 @@ class CompositeHash;
 class HashKey;
 class Frame;
 
+// Receives notifications about individual elements of a TableVal being
+// inserted, changed or removed.  This complements notifier::Modifiable,
+// which only tells receivers that *something* changed.  Expiration of
+// elements isn't reported.
+class TableElementObserver {
+public:
+	virtual ~TableElementObserver() = default;
+
+	// Called after the element with index hash key k has been assigned
+	// or, if removed is true, deleted.  The key is only valid during
+	// the call.
+	virtual void ElementModified(TableVal* t, const HashKey* k, bool removed) = 0;
+};
+
 class TableVal final : public Val, public notifier::Modifiable {
 public:
 	explicit TableVal(IntrusivePtr<TableType> t, IntrusivePtr<Attributes> attrs = nullptr);
@@ -832,6 +843,11 @@ public:
 
 	notifier::Modifiable* Modifiable() override	{ return this; }
 
+	// Sets (or with nullptr, clears) the observer notified about
+	// element-level modifications.  Does not take ownership.
+	void SetElementObserver(TableElementObserver* o)	{ element_observer = o; }
+	TableElementObserver* ElementObserver() const	{ return element_observer; }
+
 	// Retrieves and saves all table state (key-value pairs) for
 	// tables whose index type depends on the given RecordType.
 	static void SaveParseTimeTableState(RecordType* rt);
@@ -894,6 +910,7 @@ protected:
 	IntrusivePtr<Expr> change_func;
 	// prevent recursion of change functions
 	bool in_change_func = false;
+	TableElementObserver* element_observer = nullptr;
 
 	static TableRecordDependencies parse_time_table_record_dependencies;
 	static ParseTimeTableStates parse_time_table_states;
@@ -906,11 +923,54 @@ public:
 
 	IntrusivePtr<Val> SizeVal() const override;
 
+	// Values of fields of scalar type get stored directly, without
+	// keeping the Val. The Val* version keeps it if the record holds
+	// the only reference, so that the caller's pointer stays valid.
 	void Assign(int field, IntrusivePtr<Val> new_val);
 	void Assign(int field, Val* new_val);
 	Val* Lookup(int field) const;	// Does not Ref() value.
 	IntrusivePtr<Val> LookupWithDefault(int field) const;
 
+	/**
+	 * Returns true if a field has a value. Unlike Lookup(), this never
+	 * needs to create a Val.
+	 */
+	bool HasField(int field) const	{ return states[field] != SLOT_UNSET; }
+
+	/**
+	 * Assigns a value to a field of scalar type without going through a
+	 * Val, which then only gets created once somebody looks up the
+	 * field.
+	 *
+	 * AssignInt() is for fields of type bool, int and enum,
+	 * AssignUnsigned() for count and counter, and AssignDouble() for
+	 * double, time and interval.
+	 *
+	 * @param field the field's offset.
+	 *
+	 * @param v the field's new value.
+	 */
+	void AssignInt(int field, bro_int_t v);
+	void AssignUnsigned(int field, bro_uint_t v);
+	void AssignDouble(int field, double v);
+	void AssignAddr(int field, const IPAddr& v);
+	void AssignPort(int field, uint32_t port_num, TransportProto port_type);
+
+	/**
+	 * Returns the internal value of a field of scalar type, without
+	 * creating a Val for it. The field must be set.
+	 *
+	 * FieldInt() is for fields of type bool, int and enum,
+	 * FieldUnsigned() for count, counter and port (with its mask), and
+	 * FieldDouble() for double, time and interval.
+	 *
+	 * @param field the field's offset.
+	 */
+	bro_int_t FieldInt(int field) const;
+	bro_uint_t FieldUnsigned(int field) const;
+	double FieldDouble(int field) const;
+	IPAddr FieldAddr(int field) const;
+
 	/**
 	 * Looks up the value of a field by field name.  If the field doesn't
 	 * exist in the record type, it's an internal error: abort.
@@ -962,8 +1022,51 @@ public:
 protected:
 	IntrusivePtr<Val> DoClone(CloneState* state) override;
 
+	// Storage of a single field. Fields of scalar type can hold their
+	// value directly, in which case a Val for them gets created only
+	// when looked up, and kept from then on.
+	union FieldSlot {
+		bro_int_t int_val;
+		bro_uint_t uint_val;
+		double double_val;
+		uint32_t addr_val[4];	// network order
+		Val* val;
+	};
+
+	enum SlotState : uint8_t {
+		SLOT_UNSET,	// no value
+		SLOT_VAL,	// value held by slot.val
+		SLOT_INLINE,	// value held directly
+	};
+
+	// Returns the internal type of a field's values if they can be
+	// stored directly, and TYPE_INTERNAL_VOID if not.
+	InternalTypeTag InlineType(int field) const;
+
+	// Stores the value of the given Val directly if it's of scalar
+	// type. Returns false if not.
+	bool AssignInline(int field, Val* v);
+
+	// Creates the Val for a field whose value is held directly.
+	Val* MakeVal(int field) const;
+
+	void ClearField(int field);
+	void SetInline(int field, const FieldSlot& s);
+
+	friend class Val;
+
+	// Fills and returns field_list for the deprecated Val::AsRecord().
+	const val_list* FieldList() const;
+
 	BroObj* origin;
 
+	mutable std::vector<FieldSlot> slots;
+	mutable std::vector<SlotState> states;
+
+	// The field values as of the last FieldList() call.  They remain
+	// owned by the record.
+	mutable val_list* field_list = nullptr;
+
 	using RecordTypeValMap = std::unordered_map<RecordType*, std::vector<IntrusivePtr<RecordVal>>>;
 	static RecordTypeValMap parse_time_records;
 };
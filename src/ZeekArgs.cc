@@ -2,6 +2,12 @@
 #include "IntrusivePtr.h"
 #include "Val.h"
 
+// Argument lists whose storage is up for reuse.  The limits keep a burst of
+// events, or one with unusually many arguments, from pinning memory.
+static std::vector<zeek::Args> spare_arg_lists;
+static constexpr size_t max_spare_arg_lists = 1024;
+static constexpr size_t max_spare_arg_capacity = 16;
+
 zeek::Args zeek::val_list_to_args(const val_list& vl)
 	{
 	zeek::Args rval;
@@ -13,3 +19,31 @@ zeek::Args zeek::val_list_to_args(const val_list& vl)
 	return rval;
 	}
 
+zeek::Args zeek::spare_args(size_t n)
+	{
+	zeek::Args rval;
+
+	if ( ! spare_arg_lists.empty() )
+		{
+		rval = std::move(spare_arg_lists.back());
+		spare_arg_lists.pop_back();
+		}
+
+	rval.reserve(n);
+	return rval;
+	}
+
+void zeek::recycle_args(zeek::Args& args)
+	{
+	args.clear();
+
+	if ( args.capacity() == 0 || args.capacity() > max_spare_arg_capacity ||
+	     spare_arg_lists.size() >= max_spare_arg_lists )
+		{
+		zeek::Args().swap(args);
+		return;
+		}
+
+	spare_arg_lists.emplace_back(std::move(args));
+	args.clear();
+	}
@@ -3,11 +3,11 @@
 #pragma once
 
 #include "BroList.h"
+#include "IntrusivePtr.h"
 
 #include <vector>
 
 class Val;
-template <class T> class IntrusivePtr;
 
 namespace zeek {
 
@@ -23,4 +23,36 @@ using Args = std::vector<IntrusivePtr<Val>>;
  */
 Args val_list_to_args(const val_list& vl);
 
+/**
+ * Returns an empty argument list with room for at least the given number
+ * of elements.  If possible, it reuses the storage of a list previously
+ * handed to recycle_args(), which saves allocating one for every event.
+ * Must only be used from the main thread.
+ * @param n  the number of elements to make room for
+ * @return  the empty argument list
+ */
+Args spare_args(size_t n);
+
+/**
+ * Releases the elements of an argument list that's no longer needed and
+ * keeps its storage around for a later call to spare_args().  Must only be
+ * used from the main thread.
+ * @param args  the argument list to recycle, which will be left empty
+ */
+void recycle_args(Args& args);
+
+/**
+ * Builds an argument list from the given values, reusing the storage of a
+ * recycled one if possible.
+ * @param vals  the values to put into the list
+ * @return  the argument list
+ */
+template <class... Ts>
+Args make_args(Ts&&... vals)
+	{
+	auto rval = spare_args(sizeof...(vals));
+	(rval.emplace_back(std::forward<Ts>(vals)), ...);
+	return rval;
+	}
+
 } // namespace zeek
@@ -934,6 +934,25 @@ BroFile* TransportLayerAnalyzer::GetContentsFile(unsigned int /* direction */) c
 	return nullptr;
 	}
 
+bool TransportLayerAnalyzer::ChildrenFinished() const
+	{
+	if ( HasNewChildren() )
+		return false;
+
+	for ( const auto& a : GetChildren() )
+		{
+		if ( a->IsFinished() || a->Removing() || a->IsPacketCounter() )
+			continue;
+
+		if ( pia && a == pia->AsAnalyzer() && ! pia->Matching() )
+			continue;
+
+		return false;
+		}
+
+	return true;
+	}
+
 void TransportLayerAnalyzer::PacketContents(const u_char* data, int len)
 	{
 	if ( packet_contents && len > 0 )
@@ -359,6 +359,14 @@ public:
 	 */
 	bool IsAnalyzer(const char* name);
 
+	/**
+	 * Returns true if the analyzer only counts packets and bytes rather
+	 * than looking at the payload, such as ConnSize.  Such analyzers
+	 * don't keep TransportLayerAnalyzer::ChildrenFinished() from
+	 * returning true.
+	 */
+	virtual bool IsPacketCounter() const	{ return false; }
+
 	/**
 	 * Adds a new child analyzer to the analyzer tree. If an analyzer of
 	 * the same type already exists or is prevented, the one passed in is
@@ -458,7 +466,7 @@ public:
 	 * currently queued up to be added. If you just added an analyzer,
 	 * it will not immediately be in this list.
 	 */
-	const analyzer_list& GetChildren()	{ return children; }
+	const analyzer_list& GetChildren() const	{ return children; }
 
 	/**
 	 * Returns a pointer to the parent analyzer, or null if this instance
@@ -606,7 +614,7 @@ public:
 	  std::is_convertible_v<
 	    std::tuple_element_t<0, std::tuple<Args...>>, IntrusivePtr<Val>>>
 	EnqueueConnEvent(EventHandlerPtr h, Args&&... args)
-		{ return EnqueueConnEvent(h, zeek::Args{std::forward<Args>(args)...}); }
+		{ return EnqueueConnEvent(h, zeek::make_args(std::forward<Args>(args)...)); }
 
 	/**
 	 * Convenience function that forwards directly to the corresponding
@@ -705,6 +713,12 @@ protected:
 	 */
 	void AppendNewChildren();
 
+	/**
+	 * Returns true if there are children queued up to be added. This is
+	 * an internal method.
+	 */
+	bool HasNewChildren() const	{ return ! new_children.empty(); }
+
 	/**
 	 * Returns true if the child analyzer is now scheduled to be
 	 * removed (and was not before)
@@ -936,6 +950,14 @@ public:
 	 */
 	pia::PIA* GetPIA() const		{ return pia; }
 
+	/**
+	 * Returns true if none of the analyzer's children is looking at the
+	 * connection's payload anymore. Children that are finished or being
+	 * removed don't count, and neither do a PIA that has stopped
+	 * matching and children that just count packets.
+	 */
+	bool ChildrenFinished() const;
+
 	/**
 	 * Helper to raise a \c packet_contents event.
 	 *
@@ -15,7 +15,8 @@ using namespace analyzer::conn_size;
 ConnSize_Analyzer::ConnSize_Analyzer(Connection* c)
     : Analyzer("CONNSIZE", c),
       orig_bytes(), resp_bytes(), orig_pkts(), resp_pkts(),
-      orig_bytes_thresh(), resp_bytes_thresh(), orig_pkts_thresh(), resp_pkts_thresh(), duration_thresh()
+      orig_bytes_thresh(), resp_bytes_thresh(), orig_pkts_thresh(), resp_pkts_thresh(), duration_thresh(),
+      pkts_idx(-1), bytes_idx(-1)
 	{
 	start_time = c->StartTime();
 	}
@@ -38,6 +39,16 @@ void ConnSize_Analyzer::Init()
 	orig_pkts_thresh = 0;
 	resp_bytes_thresh = 0;
 	resp_pkts_thresh = 0;
+
+	// endpoint is the RecordType from NetVar.h
+	pkts_idx = endpoint->FieldOffset("num_pkts");
+	bytes_idx = endpoint->FieldOffset("num_bytes_ip");
+
+	if ( pkts_idx < 0 )
+		reporter->InternalError("'endpoint' record missing 'num_pkts' field");
+
+	if ( bytes_idx < 0 )
+		reporter->InternalError("'endpoint' record missing 'num_bytes_ip' field");
 	}
 
 void ConnSize_Analyzer::Done()
@@ -173,20 +184,10 @@ void ConnSize_Analyzer::UpdateConnVal(RecordVal *conn_val)
 	RecordVal *orig_endp = conn_val->Lookup("orig")->AsRecordVal();
 	RecordVal *resp_endp = conn_val->Lookup("resp")->AsRecordVal();
 
-	// endpoint is the RecordType from NetVar.h
-	int pktidx = endpoint->FieldOffset("num_pkts");
-	int bytesidx = endpoint->FieldOffset("num_bytes_ip");
-
-	if ( pktidx < 0 )
-		reporter->InternalError("'endpoint' record missing 'num_pkts' field");
-
-	if ( bytesidx < 0 )
-		reporter->InternalError("'endpoint' record missing 'num_bytes_ip' field");
-
-	orig_endp->Assign(pktidx, val_mgr->Count(orig_pkts));
-	orig_endp->Assign(bytesidx, val_mgr->Count(orig_bytes));
-	resp_endp->Assign(pktidx, val_mgr->Count(resp_pkts));
-	resp_endp->Assign(bytesidx, val_mgr->Count(resp_bytes));
+	orig_endp->AssignUnsigned(pkts_idx, orig_pkts);
+	orig_endp->AssignUnsigned(bytes_idx, orig_bytes);
+	resp_endp->AssignUnsigned(pkts_idx, resp_pkts);
+	resp_endp->AssignUnsigned(bytes_idx, resp_bytes);
 
 	Analyzer::UpdateConnVal(conn_val);
 	}
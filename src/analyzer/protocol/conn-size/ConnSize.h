@@ -19,6 +19,7 @@ public:
 	// from Analyzer.h
 	void UpdateConnVal(RecordVal *conn_val) override;
 	void FlipRoles() override;
+	bool IsPacketCounter() const override	{ return true; }
 
 	void SetByteAndPacketThreshold(uint64_t threshold, bool bytes, bool orig);
 	uint64_t GetByteAndPacketThreshold(bool bytes, bool orig);
@@ -48,6 +49,10 @@ protected:
 
 	double start_time;
 	double duration_thresh;
+
+	// Offsets of the endpoint record's num_pkts and num_bytes_ip fields.
+	int pkts_idx;
+	int bytes_idx;
 };
 
 } } // namespace analyzer::* 
@@ -1395,6 +1395,18 @@ void DNS_Interpreter::SendReplyOrRejectEvent(DNS_MsgInfo* msg,
 
 	assert(event);
 
+	// Don't bother building the arguments if a script filter would drop
+	// the event anyway.
+	if ( event->HasArgFilters() &&
+	     ! (event->Accepts(3, qtype) && event->Accepts(4, qclass) &&
+	        event->Accepts(2, std::string((const char*) question_name->Bytes(),
+	                                      question_name->Len()))) )
+		{
+		delete question_name;
+		++num_events_filtered;
+		return;
+		}
+
 	analyzer->EnqueueConnEvent(event,
 		analyzer->ConnVal(),
 		IntrusivePtr{AdoptRef{}, msg->BuildHdrVal()},
@@ -1669,6 +1669,12 @@ void HTTP_Analyzer::HTTP_Header(bool is_orig, mime::MIME_Header* h)
 		if ( DEBUG_http )
 			DEBUG_MSG("%.6f http_header\n", network_time);
 
+		if ( http_header->HasArgFilters() && ! HeaderPassesFilters(hd_name) )
+			{
+			++num_events_filtered;
+			return;
+			}
+
 		EnqueueConnEvent(http_header,
 			ConnVal(),
 			val_mgr->Bool(is_orig),
@@ -1679,6 +1685,29 @@ void HTTP_Analyzer::HTTP_Header(bool is_orig, mime::MIME_Header* h)
 		}
 	}
 
+bool HTTP_Analyzer::HeaderPassesFilters(const data_chunk_t& name) const
+	{
+	// Arguments 2 and 3 of http_header are the header's original and
+	// upper-cased names.
+	std::string original_name(name.data, name.length);
+
+	if ( ! http_header->Accepts(2, original_name) )
+		return false;
+
+	std::string upper_name = original_name;
+
+	// Same as BroString::ToUpper(), which builds the event's argument.
+	for ( auto& c : upper_name )
+		{
+		auto uc = static_cast<unsigned char>(c);
+
+		if ( islower(uc) )
+			c = toupper(uc);
+		}
+
+	return http_header->Accepts(3, upper_name);
+	}
+
 void HTTP_Analyzer::HTTP_EntityData(bool is_orig, BroString* entity_data)
 	{
 	if ( http_entity_data )
@@ -208,6 +208,10 @@ public:
 protected:
 	void GenStats();
 
+	// Checks a header's name against the argument filters of
+	// http_header before building the event's arguments.
+	bool HeaderPassesFilters(const data_chunk_t& name) const;
+
 	int HTTP_RequestLine(const char* line, const char* end_of_line);
 	int HTTP_ReplyLine(const char* line, const char* end_of_line);
 
@@ -35,6 +35,9 @@ public:
 
 	void ReplayPacketBuffer(analyzer::Analyzer* analyzer);
 
+	// Returns false once the PIA has stopped looking at further input.
+	virtual bool Matching() const	{ return pkt_buffer.state != SKIPPING; }
+
 	// Children are also derived from Analyzer. Return this object
 	// as pointer to an Analyzer.
 	analyzer::Analyzer* AsAnalyzer()	{ return as_analyzer; }
@@ -140,6 +143,9 @@ public:
 
 	void ReplayStreamBuffer(analyzer::Analyzer* analyzer);
 
+	bool Matching() const override
+		{ return stream_mode ? stream_buffer.state != SKIPPING : PIA::Matching(); }
+
 	static analyzer::Analyzer* Instantiate(Connection* conn)
 		{ return new PIA_TCP(conn); }
 
@@ -14,6 +14,7 @@
 #include "Event.h"
 #include "Reporter.h"
 #include "Sessions.h"
+#include "Stats.h"
 #include "DebugLogger.h"
 
 #include "events.bif.h"
@@ -133,6 +134,7 @@ TCP_Analyzer::TCP_Analyzer(Connection* conn)
 	deferred_gen_event = close_deferred = 0;
 
 	seen_first_ACK = 0;
+	stats_only = 0;
 	is_active = 1;
 	finished = 0;
 	reassembling = 0;
@@ -806,6 +808,40 @@ bool TCP_Analyzer::DeliverData(double t, const u_char* data, int len, int caplen
 	return endpoint->DataSent(t, rel_data_seq, len, caplen, data, ip, tp);
 	}
 
+bool TCP_Analyzer::OnlyStatsNeeded() const
+	{
+	if ( ! ChildrenFinished() )
+		return false;
+
+	for ( const TCP_Endpoint* endp : {orig, resp} )
+		{
+		if ( endp->GetContentsFile() )
+			return false;
+
+		if ( endp->contents_processor &&
+		     endp->contents_processor->DeliversContents() )
+			return false;
+		}
+
+	return true;
+	}
+
+void TCP_Analyzer::EnterStatsOnly()
+	{
+	// Nothing can pick up the stream again at this point: the PIA has
+	// stopped matching, so no further analyzers get attached.
+	DBG_LOG(DBG_ANALYZER, "%s no analyzers left, tracking state only",
+	        fmt_analyzer(this).c_str());
+
+	stats_only = 1;
+
+	for ( TCP_Endpoint* endp : {orig, resp} )
+		if ( endp->contents_processor )
+			endp->contents_processor->StopBuffering();
+
+	++stats_only_tcp_conns;
+	}
+
 void TCP_Analyzer::CheckRecording(bool need_contents, TCP_Flags flags)
 	{
 	bool record_current_content = need_contents || Conn()->RecordContents();
@@ -1215,6 +1251,14 @@ void TCP_Analyzer::DeliverPacket(int len, const u_char* data, bool is_orig,
 
 	uint64_t rel_data_seq = flags.SYN() ? rel_seq + 1 : rel_seq;
 
+	// Once the analyzers are all done with the connection, there's no
+	// point in buffering its payload any further.
+	if ( len > 0 && ! stats_only && BifConst::tcp_stats_only_after_analysis &&
+	     OnlyStatsNeeded() )
+		EnterStatsOnly();
+
+	// Still passed on in stats-only mode, so that the reassemblers
+	// can track the sequence space for gap accounting.
 	int need_contents = 0;
 	if ( len > 0 && (caplen >= len || packet_children.size()) &&
 	     ! flags.RST() && ! Skipping() && ! seq_underflow )
@@ -1258,7 +1302,7 @@ void TCP_Analyzer::DeliverPacket(int len, const u_char* data, bool is_orig,
 			}
 		}
 
-	if ( ! reassembling )
+	if ( ! reassembling && ! stats_only )
 		ForwardPacket(len, data, is_orig, rel_data_seq, ip, caplen);
 	}
 
@@ -1289,10 +1333,10 @@ void TCP_Analyzer::UpdateConnVal(RecordVal *conn_val)
 	RecordVal *orig_endp_val = conn_val->Lookup("orig")->AsRecordVal();
 	RecordVal *resp_endp_val = conn_val->Lookup("resp")->AsRecordVal();
 
-	orig_endp_val->Assign(0, val_mgr->Count(orig->Size()));
-	orig_endp_val->Assign(1, val_mgr->Count(int(orig->state)));
-	resp_endp_val->Assign(0, val_mgr->Count(resp->Size()));
-	resp_endp_val->Assign(1, val_mgr->Count(int(resp->state)));
+	orig_endp_val->AssignUnsigned(0, orig->Size());
+	orig_endp_val->AssignUnsigned(1, int(orig->state));
+	resp_endp_val->AssignUnsigned(0, resp->Size());
+	resp_endp_val->AssignUnsigned(1, int(resp->state));
 
 	// Call children's UpdateConnVal
 	Analyzer::UpdateConnVal(conn_val);
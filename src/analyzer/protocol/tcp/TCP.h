@@ -138,6 +138,14 @@ protected:
 			TCP_Endpoint* endpoint, uint64_t rel_data_seq,
 			bool is_orig, TCP_Flags flags);
 
+	// Returns true if nothing beyond the TCP state tracking and the
+	// packet-level children (e.g., ConnSize) needs the payload anymore.
+	bool OnlyStatsNeeded() const;
+
+	// Switches to just keeping state, with no more reassembly.  Only
+	// done with tcp_stats_only_after_analysis.
+	void EnterStatsOnly();
+
 	void CheckRecording(bool need_contents, TCP_Flags flags);
 	void CheckPIA_FirstPacket(bool is_orig, const IP_Hdr* ip);
 
@@ -187,6 +195,9 @@ private:
 
 	// Whether we have seen the first ACK from the originator.
 	unsigned int seen_first_ACK: 1;
+
+	// Whether the payload no longer goes anywhere; see EnterStatsOnly().
+	unsigned int stats_only: 1;
 };
 
 class TCP_ApplicationAnalyzer : public analyzer::Analyzer {
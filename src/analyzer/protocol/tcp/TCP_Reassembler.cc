@@ -33,6 +33,7 @@ TCP_Reassembler::TCP_Reassembler(analyzer::Analyzer* arg_dst_analyzer,
 	record_contents_file = nullptr;
 	deliver_tcp_contents = false;
 	skip_deliveries = false;
+	stats_only = false;
 	did_EOF = false;
 	seq_to_skip = 0;
 	in_delivery = false;
@@ -486,6 +487,14 @@ bool TCP_Reassembler::DataSent(double t, uint64_t seq, int len,
 	if ( skip_deliveries )
 		return false;
 
+	if ( stats_only )
+		{
+		if ( len > 0 )
+			RangeSent(seq, upper_seq);
+
+		return false;
+		}
+
 	if ( seq < ack && ! replaying )
 		{
 		if ( upper_seq <= ack )
@@ -541,7 +550,7 @@ void TCP_Reassembler::AckReceived(uint64_t seq)
 			(endp->state == TCP_ENDPOINT_ESTABLISHED &&
 				endp->peer->state == TCP_ENDPOINT_ESTABLISHED ) );
 
-	uint64_t num_missing = TrimToSeq(seq);
+	uint64_t num_missing = stats_only ? TrimRangesToSeq(seq) : TrimToSeq(seq);
 
 	if ( test_active )
 		{
@@ -560,6 +569,76 @@ void TCP_Reassembler::AckReceived(uint64_t seq)
 	CheckEOF();
 	}
 
+void TCP_Reassembler::StopBuffering()
+	{
+	// Data buffered above a hole has been seen all the same.
+	for ( auto it = block_list.Begin(); it != block_list.End(); ++it )
+		{
+		const auto& b = it->second;
+
+		if ( b.upper > last_reassem_seq )
+			RangeSent(std::max(b.seq, last_reassem_seq), b.upper);
+		}
+
+	ClearBlocks();
+	stats_only = true;
+	}
+
+void TCP_Reassembler::RangeSent(uint64_t seq, uint64_t upper)
+	{
+	if ( upper <= last_reassem_seq )
+		// Retransmission.
+		return;
+
+	if ( seq <= last_reassem_seq )
+		{
+		// In order, so it counts as delivered.  That may close the
+		// hole below the ranges seen before.
+		last_reassem_seq = upper;
+
+		while ( ! ranges.empty() && ranges.begin()->first <= last_reassem_seq )
+			{
+			last_reassem_seq = std::max(last_reassem_seq, ranges.begin()->second);
+			ranges.erase(ranges.begin());
+			}
+
+		return;
+		}
+
+	auto it = ranges.upper_bound(seq);
+
+	if ( it != ranges.begin() && std::prev(it)->second >= seq )
+		--it;
+	else
+		it = ranges.emplace_hint(it, seq, upper);
+
+	it->second = std::max(it->second, upper);
+
+	// Merge the ranges that now overlap.
+	for ( auto next = std::next(it);
+	      next != ranges.end() && next->first <= it->second;
+	      next = ranges.erase(next) )
+		it->second = std::max(it->second, next->second);
+	}
+
+uint64_t TCP_Reassembler::TrimRangesToSeq(uint64_t seq)
+	{
+	uint64_t num_missing = 0;
+
+	while ( ! ranges.empty() && ranges.begin()->first < seq )
+		{
+		auto first = ranges.begin();
+
+		// Reports the hole below the range.
+		num_missing += TrimToSeq(first->first);
+
+		last_reassem_seq = std::max(last_reassem_seq, first->second);
+		ranges.erase(first);
+		}
+
+	return num_missing + TrimToSeq(seq);
+	}
+
 void TCP_Reassembler::CheckEOF()
 	{
 	// It is important that the check on whether we have pending data here
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <map>
+
 #include "Reassem.h"
 #include "TCP_Endpoint.h"
 #include "TCP_Flags.h"
@@ -69,6 +71,16 @@ public:
 	// when so.
 	void CheckEOF();
 
+	// Stops buffering and delivering data for good, dropping whatever
+	// is buffered. From then on, only the sequence ranges of the data
+	// sent get tracked, so acks still reveal content gaps.
+	void StopBuffering();
+
+	// Returns true if the stream's contents are needed by someone
+	// beyond the analyzers, i.e., tcp_contents or a contents file.
+	bool DeliversContents() const
+		{ return deliver_tcp_contents || record_contents_file; }
+
 	bool HasUndeliveredData() const	{ return HasBlocks(); }
 	bool HadGap() const	{ return had_gap; }
 	bool DataPending() const;
@@ -98,12 +110,24 @@ private:
 	void BlockInserted(DataBlockMap::const_iterator it) override;
 	void Overlap(const u_char* b1, const u_char* b2, uint64_t n) override;
 
+	// Notes data sent in [seq, upper) once we've stopped buffering.
+	void RangeSent(uint64_t seq, uint64_t upper);
+
+	// Like TrimToSeq(), but for the sequence ranges tracked once we've
+	// stopped buffering: reports each hole below seq as a gap.
+	uint64_t TrimRangesToSeq(uint64_t seq);
+
 	TCP_Endpoint* endp;
 
 	bool deliver_tcp_contents;
 	bool had_gap;
 	bool did_EOF;
 	bool skip_deliveries;
+	bool stats_only;
+
+	// Once we've stopped buffering, the data seen above the first hole,
+	// as a map of each range's start to its upper end.
+	std::map<uint64_t, uint64_t> ranges;
 
 	uint64_t seq_to_skip;
 
@@ -0,0 +1,127 @@
+// See the file "COPYING" in the main distribution directory for copyright.
+
+// Measures how fast the event manager queues and dispatches events shaped
+// like the ones analyzers raise per packet: a connection-like record plus a
+// few scalar arguments, drained in batches.
+
+#include <unistd.h>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+
+#include "Event.h"
+#include "EventHandler.h"
+#include "Trigger.h"
+#include "Type.h"
+#include "Val.h"
+#include "iosource/Manager.h"
+#include "plugin/Manager.h"
+#include "util.h"
+
+using Clock = std::chrono::steady_clock;
+
+static void usage(const char* prog)
+	{
+	fprintf(stderr, "usage: %s [-n events] [-b batch-size]\n", prog);
+	exit(1);
+	}
+
+static void report(const char* what, Clock::duration d, uint64_t n)
+	{
+	double secs = std::chrono::duration<double>(d).count();
+	printf("%-12s %8.3f s  %7.2f ns/event  %7.2f M events/s\n",
+	       what, secs, secs * 1e9 / n, n / secs / 1e6);
+	}
+
+static IntrusivePtr<RecordVal> make_conn()
+	{
+	auto decls = new type_decl_list();
+	decls->push_back(new TypeDecl(base_type(TYPE_STRING), copy_string("uid")));
+	decls->push_back(new TypeDecl(base_type(TYPE_COUNT), copy_string("num_pkts")));
+	decls->push_back(new TypeDecl(base_type(TYPE_TIME), copy_string("start_time")));
+
+	auto conn_type = make_intrusive<RecordType>(decls);
+	auto c = make_intrusive<RecordVal>(conn_type.get());
+	c->Assign(0, make_intrusive<StringVal>("CHhAvVGS1DHFjwGM9"));
+	c->AssignUnsigned(1, 0);
+	c->AssignDouble(2, 1.0);
+	return c;
+	}
+
+int main(int argc, char** argv)
+	{
+	uint64_t num_events = 50000000;
+	int batch = 100;
+	int opt;
+
+	while ( (opt = getopt(argc, argv, "n:b:")) != -1 )
+		{
+		switch ( opt ) {
+		case 'n':
+			num_events = strtoull(optarg, nullptr, 10);
+			break;
+
+		case 'b':
+			batch = atoi(optarg);
+			break;
+
+		default:
+			usage(argv[0]);
+		}
+		}
+
+	if ( batch <= 0 )
+		usage(argv[0]);
+
+	iosource_mgr = new iosource::Manager();
+	plugin_mgr = new plugin::Manager();
+	trigger_mgr = new trigger::Manager();
+	val_mgr = new ValManager();
+
+	EventHandler handler("connection_established");
+	EventHandlerPtr h(&handler);
+	auto c = make_conn();
+
+	printf("%" PRIu64 " events in batches of %d\n", num_events, batch);
+
+	// Argument vectors built by the caller, as with Enqueue(h, zeek::Args).
+	uint64_t start_dispatched = num_events_dispatched;
+	auto start = Clock::now();
+
+	for ( uint64_t i = 0; i < num_events; )
+		{
+		for ( int j = 0; j < batch && i < num_events; ++j, ++i )
+			mgr.Enqueue(h, zeek::Args{c, val_mgr->Count(i), val_mgr->True()});
+
+		mgr.Drain();
+		}
+
+	report("Args", Clock::now() - start, num_events);
+	uint64_t args_dispatched = num_events_dispatched - start_dispatched;
+
+	// Argument lists recycled from dispatched events, as with the
+	// variadic Enqueue() and EnqueueConnEvent().
+	start_dispatched = num_events_dispatched;
+	start = Clock::now();
+
+	for ( uint64_t i = 0; i < num_events; )
+		{
+		for ( int j = 0; j < batch && i < num_events; ++j, ++i )
+			mgr.Enqueue(h, c, val_mgr->Count(i), val_mgr->True());
+
+		mgr.Drain();
+		}
+
+	report("variadic", Clock::now() - start, num_events);
+	uint64_t variadic_dispatched = num_events_dispatched - start_dispatched;
+
+	if ( args_dispatched != num_events || variadic_dispatched != num_events )
+		{
+		fprintf(stderr, "dispatched %" PRIu64 " and %" PRIu64 " events\n",
+		        args_dispatched, variadic_dispatched);
+		return 1;
+		}
+
+	return 0;
+	}
@@ -0,0 +1,221 @@
+// See the file "COPYING" in the main distribution directory for copyright.
+
+// Measures longest-prefix matches of single addresses through PrefixTable
+// against plain lookups in the patricia tree it's built on.
+
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "IPAddr.h"
+#include "NetVar.h"
+#include "PrefixTable.h"
+
+using Clock = std::chrono::steady_clock;
+
+static void usage(const char* prog)
+	{
+	fprintf(stderr, "usage: %s [-n lookups] [-p prefixes] [-m max-trie-bytes] [rib-file]\n", prog);
+	exit(1);
+	}
+
+static bool read_rib(const char* file, std::vector<IPPrefix>* prefixes)
+	{
+	std::ifstream in(file);
+
+	if ( ! in )
+		return false;
+
+	std::string line;
+
+	while ( std::getline(in, line) )
+		{
+		auto end = line.find_first_of(" \t");
+
+		if ( end != std::string::npos )
+			line.resize(end);
+
+		IPPrefix p;
+
+		if ( IPPrefix::ConvertString(line.c_str(), &p) )
+			prefixes->push_back(p);
+		}
+
+	return true;
+	}
+
+// Random IPv4 prefixes with a length distribution resembling a BGP table:
+// about 60% /24s and most of the rest between /16 and /23.
+static void random_prefixes(std::mt19937& rng, int n, std::vector<IPPrefix>* prefixes)
+	{
+	static const int lengths[] = {
+		8, 12, 16, 16, 18, 19, 20, 20, 21, 22, 22, 22, 23, 23,
+		24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24, 24,
+		24, 24, 24, 24, 24, 24, 24, 24, 24, 28, 32,
+	};
+
+	for ( int i = 0; i < n; ++i )
+		{
+		uint32_t a = rng();
+		int len = lengths[rng() % (sizeof(lengths) / sizeof(lengths[0]))];
+		prefixes->emplace_back(IPAddr(IPv4, &a, IPAddr::Host), len);
+		}
+	}
+
+static prefix_t* make_prefix(const IPAddr& addr, int width)
+	{
+	prefix_t* prefix = (prefix_t*) malloc(sizeof(prefix_t));
+	addr.CopyIPv6(&prefix->add.sin6);
+	prefix->family = AF_INET6;
+	prefix->bitlen = width;
+	prefix->ref_count = 1;
+	return prefix;
+	}
+
+static void report(const char* what, Clock::duration d, uint64_t n)
+	{
+	double secs = std::chrono::duration<double>(d).count();
+	printf("%-12s %8.3f s  %7.2f ns/lookup  %7.2f M lookups/s\n",
+	       what, secs, secs * 1e9 / n, n / secs / 1e6);
+	}
+
+int main(int argc, char** argv)
+	{
+	uint64_t num_lookups = 100000000;
+	int num_prefixes = 1000000;
+	int c;
+
+	// No script-level default applies here; leave room for large tables.
+	subnet_lookup_trie_max_bytes = 1024 * 1024 * 1024;
+
+	while ( (c = getopt(argc, argv, "n:p:m:")) != -1 )
+		{
+		switch ( c ) {
+		case 'n':
+			num_lookups = strtoull(optarg, nullptr, 10);
+			break;
+
+		case 'p':
+			num_prefixes = atoi(optarg);
+			break;
+
+		case 'm':
+			subnet_lookup_trie_max_bytes = strtoull(optarg, nullptr, 10);
+			break;
+
+		default:
+			usage(argv[0]);
+		}
+		}
+
+	std::mt19937 rng(42);
+	std::vector<IPPrefix> prefixes;
+
+	if ( optind < argc )
+		{
+		if ( ! read_rib(argv[optind], &prefixes) )
+			{
+			fprintf(stderr, "cannot read %s\n", argv[optind]);
+			return 1;
+			}
+		}
+	else
+		random_prefixes(rng, num_prefixes, &prefixes);
+
+	if ( prefixes.empty() )
+		usage(argv[0]);
+
+	PrefixTable table;
+	patricia_tree_t* tree = New_Patricia(128);
+
+	for ( size_t i = 0; i < prefixes.size(); ++i )
+		{
+		const auto& p = prefixes[i];
+		void* data = (void*) (i + 1);
+		table.Insert(p.Prefix(), p.LengthIPv6(), data);
+
+		prefix_t* prefix = make_prefix(p.Prefix(), p.LengthIPv6());
+		patricia_lookup(tree, prefix)->data = data;
+		Deref_Prefix(prefix);
+		}
+
+	// Addresses to look up: mostly within the prefixes, the rest random.
+	std::vector<IPAddr> addrs;
+	std::vector<prefix_t> addr_prefixes;
+	size_t num_addrs = std::min(uint64_t(1 << 20), num_lookups);
+
+	for ( size_t i = 0; i < num_addrs; ++i )
+		{
+		uint32_t r[4] = { uint32_t(rng()), uint32_t(rng()), uint32_t(rng()), uint32_t(rng()) };
+		IPAddr a;
+
+		if ( i % 4 == 0 )
+			a = IPAddr(IPv4, r, IPAddr::Host);
+		else
+			{
+			const auto& p = prefixes[rng() % prefixes.size()];
+			uint32_t net[4];
+			p.Prefix().CopyIPv6(net, IPAddr::Network);
+
+			for ( int j = 0; j < 4; ++j )
+				{
+				int bits = std::min(std::max(p.LengthIPv6() - 32 * j, 0), 32);
+				uint32_t mask = bits ? htonl(~0u << (32 - bits)) : 0;
+				r[j] = (net[j] & mask) | (r[j] & ~mask);
+				}
+
+			a = IPAddr(IPv6, r, IPAddr::Network);
+			}
+
+		addrs.push_back(a);
+
+		prefix_t prefix;
+		a.CopyIPv6(&prefix.add.sin6);
+		prefix.family = AF_INET6;
+		prefix.bitlen = 128;
+		prefix.ref_count = 0;
+		addr_prefixes.push_back(prefix);
+		}
+
+	printf("%zu prefixes, %d tree nodes, %" PRIu64 " lookups of %zu addresses\n",
+	       prefixes.size(), tree->num_active_node, num_lookups, num_addrs);
+
+	uintptr_t patricia_sum = 0;
+	auto start = Clock::now();
+
+	for ( uint64_t i = 0; i < num_lookups; ++i )
+		{
+		patricia_node_t* node =
+			patricia_search_best(tree, &addr_prefixes[i % num_addrs]);
+
+		if ( node )
+			patricia_sum += (uintptr_t) node->data;
+		}
+
+	report("patricia", Clock::now() - start, num_lookups);
+
+	uintptr_t table_sum = 0;
+	start = Clock::now();
+
+	for ( uint64_t i = 0; i < num_lookups; ++i )
+		table_sum += (uintptr_t) table.Lookup(addrs[i % num_addrs], 128);
+
+	report("PrefixTable", Clock::now() - start, num_lookups);
+
+	Destroy_Patricia(tree, nullptr);
+
+	if ( patricia_sum != table_sum )
+		{
+		fprintf(stderr, "results differ\n");
+		return 1;
+		}
+
+	return 0;
+	}
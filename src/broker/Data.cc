@@ -77,6 +77,96 @@ TEST_CASE("converting Broker to Zeek protocol constants")
 	         TRANSPORT_UNKNOWN);
 	}
 
+IntrusivePtr<ListVal> bro_broker::data_to_index_val(broker::data& key, TableType* tt)
+	{
+	auto expected_index_types = tt->Indices()->Types();
+	broker::vector composite_key;
+	auto indices = caf::get_if<broker::vector>(&key);
+
+	if ( indices )
+		{
+		if ( expected_index_types->length() == 1 )
+			{
+			auto index_is_vector_or_record =
+			     (*expected_index_types)[0]->Tag() == TYPE_RECORD ||
+			     (*expected_index_types)[0]->Tag() == TYPE_VECTOR;
+
+			if ( index_is_vector_or_record )
+				{
+				// Disambiguate from composite key w/ multiple vals.
+				composite_key.emplace_back(move(key));
+				indices = &composite_key;
+				}
+			}
+		}
+	else
+		{
+		composite_key.emplace_back(move(key));
+		indices = &composite_key;
+		}
+
+	if ( static_cast<size_t>(expected_index_types->length()) !=
+	     indices->size() )
+		return nullptr;
+
+	auto list_val = make_intrusive<ListVal>(TYPE_ANY);
+
+	for ( auto i = 0u; i < indices->size(); ++i )
+		{
+		auto index_val = bro_broker::data_to_val(move((*indices)[i]),
+		                                         (*expected_index_types)[i]);
+
+		if ( ! index_val )
+			return nullptr;
+
+		list_val->Append(index_val.release());
+		}
+
+	return list_val;
+	}
+
+// Adds the elements of a Broker set to a set value of the given type.
+static bool add_set_data(broker::set& a, TableType* tt, TableVal* rval)
+	{
+	for ( auto& item : a )
+		{
+		// Set elements are const, so convert a copy.
+		auto key = item;
+		auto list_val = data_to_index_val(key, tt);
+
+		if ( ! list_val )
+			return false;
+
+		rval->Assign(list_val.get(), nullptr);
+		}
+
+	return true;
+	}
+
+// Adds the elements of a Broker table to a table value of the given type.
+static bool add_table_data(broker::table& a, TableType* tt, TableVal* rval)
+	{
+	for ( auto& item : a )
+		{
+		// Table keys are const, so convert a copy.
+		auto key = item.first;
+		auto list_val = data_to_index_val(key, tt);
+
+		if ( ! list_val )
+			return false;
+
+		auto value_val = bro_broker::data_to_val(move(item.second),
+		                                         tt->YieldType());
+
+		if ( ! value_val )
+			return false;
+
+		rval->Assign(list_val.get(), std::move(value_val));
+		}
+
+	return true;
+	}
+
 struct val_converter {
 	using result_type = Val*;
 
@@ -210,54 +300,8 @@ struct val_converter {
 		auto tt = type->AsTableType();
 		auto rval = make_intrusive<TableVal>(IntrusivePtr{NewRef{}, tt});
 
-		for ( auto& item : a )
-			{
-			auto expected_index_types = tt->Indices()->Types();
-			broker::vector composite_key;
-			auto indices = caf::get_if<broker::vector>(&item);
-
-			if ( indices )
-				{
-				if ( expected_index_types->length() == 1 )
-					{
-					auto index_is_vector_or_record =
-					     (*expected_index_types)[0]->Tag() == TYPE_RECORD ||
-					     (*expected_index_types)[0]->Tag() == TYPE_VECTOR;
-
-					if ( index_is_vector_or_record )
-						{
-						// Disambiguate from composite key w/ multiple vals.
-						composite_key.emplace_back(move(item));
-						indices = &composite_key;
-						}
-					}
-				}
-			else
-				{
-				composite_key.emplace_back(move(item));
-				indices = &composite_key;
-				}
-
-			if ( static_cast<size_t>(expected_index_types->length()) !=
-			     indices->size() )
-				return nullptr;
-
-			auto list_val = make_intrusive<ListVal>(TYPE_ANY);
-
-			for ( auto i = 0u; i < indices->size(); ++i )
-				{
-				auto index_val = bro_broker::data_to_val(move((*indices)[i]),
-				                                         (*expected_index_types)[i]);
-
-				if ( ! index_val )
-					return nullptr;
-
-				list_val->Append(index_val.release());
-				}
-
-
-			rval->Assign(list_val.get(), nullptr);
-			}
+		if ( ! add_set_data(a, tt, rval.get()) )
+			return nullptr;
 
 		return rval.release();
 		}
@@ -270,59 +314,8 @@ struct val_converter {
 		auto tt = type->AsTableType();
 		auto rval = make_intrusive<TableVal>(IntrusivePtr{NewRef{}, tt});
 
-		for ( auto& item : a )
-			{
-			auto expected_index_types = tt->Indices()->Types();
-			broker::vector composite_key;
-			auto indices = caf::get_if<broker::vector>(&item.first);
-
-			if ( indices )
-				{
-				if ( expected_index_types->length() == 1 )
-					{
-					auto index_is_vector_or_record =
-					     (*expected_index_types)[0]->Tag() == TYPE_RECORD ||
-					     (*expected_index_types)[0]->Tag() == TYPE_VECTOR;
-
-					if ( index_is_vector_or_record )
-						{
-						// Disambiguate from composite key w/ multiple vals.
-						composite_key.emplace_back(move(item.first));
-						indices = &composite_key;
-						}
-					}
-				}
-			else
-				{
-				composite_key.emplace_back(move(item.first));
-				indices = &composite_key;
-				}
-
-			if ( static_cast<size_t>(expected_index_types->length()) !=
-			     indices->size() )
-				return nullptr;
-
-			auto list_val = make_intrusive<ListVal>(TYPE_ANY);
-
-			for ( auto i = 0u; i < indices->size(); ++i )
-				{
-				auto index_val = bro_broker::data_to_val(move((*indices)[i]),
-				                                         (*expected_index_types)[i]);
-
-				if ( ! index_val )
-					return nullptr;
-
-				list_val->Append(index_val.release());
-				}
-
-			auto value_val = bro_broker::data_to_val(move(item.second),
-			                                         tt->YieldType());
-
-			if ( ! value_val )
-				return nullptr;
-
-			rval->Assign(list_val.get(), std::move(value_val));
-			}
+		if ( ! add_table_data(a, tt, rval.get()) )
+			return nullptr;
 
 		return rval.release();
 		}
@@ -795,6 +788,115 @@ IntrusivePtr<Val> bro_broker::data_to_val(broker::data d, BroType* type)
 	return {AdoptRef{}, caf::visit(val_converter{type}, std::move(d))};
 	}
 
+bool bro_broker::data_to_table_val(broker::data d, TableVal* t)
+	{
+	auto tt = t->Type()->AsTableType();
+
+	if ( auto a = caf::get_if<broker::set>(&d) )
+		return tt->IsSet() && add_set_data(*a, tt, t);
+
+	if ( auto a = caf::get_if<broker::table>(&d) )
+		return ! tt->IsSet() && add_table_data(*a, tt, t);
+
+	return false;
+	}
+
+broker::expected<broker::data> bro_broker::index_to_data(const TableVal* t,
+                                                         const HashKey* hk)
+	{
+	auto vl = t->RecoverIndex(hk);
+
+	broker::vector composite_key;
+	composite_key.reserve(vl->Length());
+
+	for ( auto k = 0; k < vl->Length(); ++k )
+		{
+		auto key_part = bro_broker::val_to_data((*vl->Vals())[k]);
+
+		if ( ! key_part )
+			return broker::ec::invalid_data;
+
+		composite_key.emplace_back(move(*key_part));
+		}
+
+	if ( composite_key.size() == 1 )
+		return {move(composite_key[0])};
+
+	return {broker::data{move(composite_key)}};
+	}
+
+// Converts a single table entry and adds it to a Broker set or table.
+static bool add_table_entry(const TableVal* table_val, const HashKey* hk,
+                            TableEntryVal* entry, bool is_set, broker::data* rval)
+	{
+	auto key = bro_broker::index_to_data(table_val, hk);
+
+	if ( ! key )
+		return false;
+
+	if ( is_set )
+		caf::get<broker::set>(*rval).emplace(move(*key));
+	else
+		{
+		auto val = bro_broker::val_to_data(entry->Value());
+
+		if ( ! val )
+			return false;
+
+		caf::get<broker::table>(*rval).emplace(move(*key), move(*val));
+		}
+
+	return true;
+	}
+
+bro_broker::TableChunker::TableChunker(IntrusivePtr<TableVal> t, size_t arg_chunk_size)
+	: table(std::move(t)), chunk_size(arg_chunk_size)
+	{
+	is_set = table->Type()->IsSet();
+	cookie = table->AsTable()->InitForIteration();
+	table->AsNonConstTable()->MakeRobustCookie(cookie);
+	}
+
+bro_broker::TableChunker::~TableChunker()
+	{
+	if ( cookie )
+		table->AsTable()->StopIteration(cookie);
+	}
+
+bool bro_broker::TableChunker::Next(broker::data* chunk)
+	{
+	if ( ! cookie )
+		return false;
+
+	if ( is_set )
+		*chunk = broker::set();
+	else
+		*chunk = broker::table();
+
+	size_t n = 0;
+	HashKey* hk;
+	TableEntryVal* entry;
+
+	while ( n < chunk_size && (entry = table->AsTable()->NextEntry(hk, cookie)) )
+		{
+		bool ok = add_table_entry(table.get(), hk, entry, is_set, chunk);
+		delete hk;
+
+		if ( ! ok )
+			{
+			failed = true;
+			table->AsTable()->StopIteration(cookie);
+			cookie = nullptr;
+			return false;
+			}
+
+		++n;
+		}
+
+	// NextEntry() releases the cookie once it runs out of elements.
+	return n > 0;
+	}
+
 broker::expected<broker::data> bro_broker::val_to_data(const Val* v)
 	{
 	switch ( v->Type()->Tag() ) {
@@ -904,39 +1006,13 @@ broker::expected<broker::data> bro_broker::val_to_data(const Val* v)
 
 		while ( (entry = table->NextEntry(hk, c)) )
 			{
-			auto vl = table_val->RecoverIndex(hk);
+			bool ok = add_table_entry(table_val, hk, entry, is_set, &rval);
 			delete hk;
 
-			broker::vector composite_key;
-			composite_key.reserve(vl->Length());
-
-			for ( auto k = 0; k < vl->Length(); ++k )
-				{
-				auto key_part = val_to_data((*vl->Vals())[k]);
-
-				if ( ! key_part )
-					return broker::ec::invalid_data;
-
-				composite_key.emplace_back(move(*key_part));
-				}
-
-			broker::data key;
-
-			if ( composite_key.size() == 1 )
-				key = move(composite_key[0]);
-			else
-				key = move(composite_key);
-
-			if ( is_set )
-				caf::get<broker::set>(rval).emplace(move(key));
-			else
+			if ( ! ok )
 				{
-				auto val = val_to_data(entry->Value());
-
-				if ( ! val )
-					return broker::ec::invalid_data;
-
-				caf::get<broker::table>(rval).emplace(move(key), move(*val));
+				table->StopIteration(c);
+				return broker::ec::invalid_data;
 				}
 			}
 
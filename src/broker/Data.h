@@ -4,6 +4,7 @@
 #include "Reporter.h"
 #include "Frame.h"
 #include "Expr.h"
+#include "IntrusivePtr.h"
 
 template <class T>
 class IntrusivePtr;
@@ -62,6 +63,75 @@ broker::expected<broker::data> val_to_data(const Val* v);
  */
 IntrusivePtr<Val> data_to_val(broker::data d, BroType* type);
 
+/**
+ * Converts a table or set value to Broker data in chunks of at most a given
+ * number of elements, one chunk per call.  The iteration uses a robust
+ * cookie, so the table may change between calls: elements added meanwhile
+ * are picked up and elements removed before being visited are skipped.
+ */
+class TableChunker {
+public:
+	/**
+	 * @param t the table or set to convert.
+	 * @param chunk_size the max number of elements per chunk.
+	 */
+	TableChunker(IntrusivePtr<TableVal> t, size_t chunk_size);
+	~TableChunker();
+
+	/**
+	 * Converts the next chunk of elements.
+	 * @param chunk set to the converted chunk, if there was one.
+	 * @return false if there are no more elements or an element
+	 * couldn't be converted, see Failed().
+	 */
+	bool Next(broker::data* chunk);
+
+	/**
+	 * @return whether an element couldn't be converted.
+	 */
+	bool Failed() const	{ return failed; }
+
+	/**
+	 * @return whether the converted value is a set.
+	 */
+	bool IsSet() const	{ return is_set; }
+
+private:
+	IntrusivePtr<TableVal> table;
+	IterCookie* cookie;
+	size_t chunk_size;
+	bool is_set;
+	bool failed = false;
+};
+
+/**
+ * Convert Broker data holding a set or table and add its elements to an
+ * existing table value, e.g. one chunk produced by a TableChunker.
+ * @param d a Broker set or table.
+ * @param t the table value to add the elements to.
+ * @return true if all elements could be converted.
+ */
+bool data_to_table_val(broker::data d, TableVal* t);
+
+/**
+ * Convert the index of a table element to Broker data, using the same
+ * representation as for keys of converted sets and tables.
+ * @param t the table the index belongs to.
+ * @param hk the hash key of the element's index.
+ * @return the converted index if all its parts could be converted.
+ */
+broker::expected<broker::data> index_to_data(const TableVal* t, const HashKey* hk);
+
+/**
+ * Convert the key of a Broker set or table element into an index for a
+ * table of the given type.
+ * @param key the key, which may get moved from.
+ * @param tt the type of the table that the index is for.
+ * @return the index or a nullptr if the key doesn't match the table's
+ * index types.
+ */
+IntrusivePtr<ListVal> data_to_index_val(broker::data& key, TableType* tt);
+
 /**
  * Convert a Bro threading::Value to a Broker data value.
  * @param v a Bro threading::Value.
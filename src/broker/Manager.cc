@@ -4,10 +4,12 @@
 #include <broker/zeek.hh>
 #include <cstdio>
 #include <cstring>
+#include <limits>
 #include <unistd.h>
 
 #include "Data.h"
 #include "Store.h"
+#include "TableSync.h"
 #include "util.h"
 #include "Var.h"
 #include "Desc.h"
@@ -131,6 +133,12 @@ Manager::Manager(bool arg_use_real_time)
 	after_zeek_init = false;
 	peer_count = 0;
 	log_batch_size = 0;
+	event_batch_size = 0;
+	id_chunk_size = 0;
+	id_chunks_per_iteration = 0;
+	id_chunk_timeout = 0;
+	table_sync_history = 0;
+	table_sync_interval = 0;
 	log_topic_func = nullptr;
 	vector_of_data_type = nullptr;
 	log_id_type = nullptr;
@@ -146,6 +154,12 @@ void Manager::InitPostScript()
 	DBG_LOG(DBG_BROKER, "Initializing");
 
 	log_batch_size = get_option("Broker::log_batch_size")->AsCount();
+	event_batch_size = get_option("Broker::event_batch_size")->AsCount();
+	id_chunk_size = get_option("Broker::id_chunk_size")->AsCount();
+	id_chunks_per_iteration = get_option("Broker::id_chunks_per_iteration")->AsCount();
+	id_chunk_timeout = get_option("Broker::id_chunk_timeout")->AsInterval();
+	table_sync_history = get_option("Broker::table_sync_history")->AsCount();
+	table_sync_interval = get_option("Broker::table_sync_interval")->AsInterval();
 	default_log_topic_prefix =
 	    get_option("Broker::default_log_topic_prefix")->AsString()->CheckString();
 	log_topic_func = get_option("Broker::log_topic")->AsFunc();
@@ -212,10 +226,102 @@ void Manager::InitPostScript()
 		reporter->FatalError("Failed to register broker subscriber with iosource_mgr");
 	if ( ! iosource_mgr->RegisterFd(bstate->status_subscriber.fd(), this) )
 		reporter->FatalError("Failed to register broker status subscriber with iosource_mgr");
+
+	RegisterTableSyncs();
+	}
+
+void Manager::RegisterTableSyncs()
+	{
+	for ( const auto& global : global_scope()->Vars() )
+		{
+		ID* id = global.second.get();
+		Attr* attr = id->FindAttr(ATTR_BROKER_SYNC);
+
+		if ( ! attr )
+			continue;
+
+		auto topic_val = attr->AttrExpr()->Eval(nullptr);
+		std::string topic = topic_val->AsString()->CheckString();
+
+		if ( table_syncs.find(topic) != table_syncs.end() )
+			{
+			reporter->Error("&broker_sync topic %s of %s is already in use",
+			                topic.c_str(), id->Name());
+			continue;
+			}
+
+		DBG_LOG(DBG_BROKER, "Synchronizing table %s on topic %s",
+		        id->Name(), topic.c_str());
+		Subscribe(topic);
+		table_syncs.emplace(topic, std::make_unique<TableSync>(id, topic, NodeID(),
+		                                                       table_sync_history));
+		}
+
+	if ( ! table_syncs.empty() )
+		timer_mgr->Add(new TableSyncTimer(network_time + table_sync_interval,
+		                                  table_sync_interval));
+	}
+
+size_t Manager::FlushTableSyncs()
+	{
+	if ( bstate->endpoint.is_shutdown() )
+		return 0;
+
+	size_t rval = 0;
+
+	for ( auto& ts : table_syncs )
+		{
+		auto msg = ts.second->Flush();
+
+		if ( msg.empty() )
+			continue;
+
+		PublishTableSync(ts.first, std::move(msg));
+		++rval;
+		}
+
+	return rval;
+	}
+
+void Manager::RequestTableSyncs(const std::string& peer)
+	{
+	for ( auto& ts : table_syncs )
+		{
+		ts.second->ResetRequests();
+		PublishTableSync(ts.first, ts.second->Request(peer));
+		}
+	}
+
+void Manager::PublishTableSync(const std::string& topic, broker::vector msg)
+	{
+	DBG_LOG(DBG_BROKER, "Publishing table sync: %s %s",
+	        topic.c_str(), RenderMessage(msg).c_str());
+	broker::zeek::Event ev("Broker::__table_sync", std::move(msg));
+	bstate->endpoint.publish(topic, ev.move_data());
+	}
+
+void Manager::ProcessTableSync(const std::string& topic, broker::vector& args)
+	{
+	auto it = table_syncs.find(topic);
+
+	if ( it == table_syncs.end() )
+		return;
+
+	std::vector<broker::vector> replies;
+
+	if ( ! it->second->Process(args, &replies) )
+		reporter->Warning("received invalid table sync message on topic %s",
+		                  topic.c_str());
+
+	for ( auto& r : replies )
+		PublishTableSync(topic, std::move(r));
 	}
 
 void Manager::Terminate()
 	{
+	FlushTableSyncs();
+	FlushEventBuffers();
+	PublishPendingIdChunks(std::numeric_limits<size_t>::max());
 	FlushLogBuffers();
 
 	iosource_mgr->UnregisterFd(bstate->subscriber.fd(), this);
@@ -346,6 +452,7 @@ void Manager::Unpeer(const string& addr, uint16_t port)
 	DBG_LOG(DBG_BROKER, "Stopping to peer with %s:%" PRIu16,
 		addr.c_str(), port);
 
+	FlushEventBuffers();
 	FlushLogBuffers();
 	bstate->endpoint.unpeer_nosync(addr, port);
 	}
@@ -371,6 +478,23 @@ bool Manager::PublishEvent(string topic, std::string name, broker::vector args)
 	if ( peer_count == 0 )
 		return true;
 
+	if ( event_batch_size > 1 )
+		{
+		DBG_LOG(DBG_BROKER, "Buffering event: %s",
+			RenderEvent(topic, name, args).c_str());
+		broker::zeek::Event ev(std::move(name), std::move(args));
+		auto& pending_batch = event_buffers[topic];
+		pending_batch.emplace_back(ev.move_data());
+
+		if ( pending_batch.size() >= event_batch_size )
+			{
+			statistics.num_events_outgoing += FlushEventBuffer(topic, pending_batch);
+			++statistics.num_event_batches_full;
+			}
+
+		return true;
+		}
+
 	DBG_LOG(DBG_BROKER, "Publishing event: %s",
 		RenderEvent(topic, name, args).c_str());
 	broker::zeek::Event ev(std::move(name), std::move(args));
@@ -379,6 +503,36 @@ bool Manager::PublishEvent(string topic, std::string name, broker::vector args)
 	return true;
 	}
 
+size_t Manager::FlushEventBuffer(const std::string& topic, broker::vector& pending_batch)
+	{
+	if ( pending_batch.empty() )
+		return 0;
+
+	broker::vector batch;
+	batch.reserve(event_batch_size);
+	pending_batch.swap(batch);
+
+	auto rval = batch.size();
+	broker::zeek::Batch msg(std::move(batch));
+	bstate->endpoint.publish(topic, msg.move_data());
+	++statistics.num_event_batches_outgoing;
+	return rval;
+	}
+
+size_t Manager::FlushEventBuffers()
+	{
+	if ( bstate->endpoint.is_shutdown() )
+		return 0;
+
+	auto rval = 0u;
+
+	for ( auto& kv : event_buffers )
+		rval += FlushEventBuffer(kv.first, kv.second);
+
+	statistics.num_events_outgoing += rval;
+	return rval;
+	}
+
 bool Manager::PublishEvent(string topic, RecordVal* args)
 	{
 	if ( bstate->endpoint.is_shutdown() )
@@ -425,6 +579,13 @@ bool Manager::PublishIdentifier(std::string topic, std::string id)
 		// receiving side, but not sure what use that would be.
 		return false;
 
+	// Make sure events published before the update arrive first.
+	FlushEventBuffers();
+
+	if ( id_chunk_size > 0 && val->Type()->Tag() == TYPE_TABLE &&
+	     static_cast<size_t>(val->AsTableVal()->Size()) > id_chunk_size )
+		return PublishIdentifierChunks(move(topic), move(id), val->AsTableVal());
+
 	auto data = val_to_data(val);
 
 	if ( ! data )
@@ -442,6 +603,94 @@ bool Manager::PublishIdentifier(std::string topic, std::string id)
 	return true;
 	}
 
+// Large tables are sent as a sequence of identifier updates whose values
+// are [ID_CHUNK_TAG, sender's node ID, sequence number, last-chunk flag,
+// chunk of elements].
+static const char* ID_CHUNK_TAG = "Broker::ID_CHUNK";
+
+static bool is_id_chunk(const broker::data& d)
+	{
+	auto v = caf::get_if<broker::vector>(&d);
+
+	if ( ! v || v->size() != 5 )
+		return false;
+
+	auto tag = caf::get_if<broker::enum_value>(&(*v)[0]);
+	return tag && tag->name == ID_CHUNK_TAG;
+	}
+
+bool Manager::PublishIdentifierChunks(std::string topic, std::string id, TableVal* t)
+	{
+	DBG_LOG(DBG_BROKER, "Publishing id-update for %s in chunks of %zu",
+	        id.c_str(), id_chunk_size);
+
+	auto chunker = std::make_unique<TableChunker>(IntrusivePtr{NewRef{}, t},
+	                                              id_chunk_size);
+
+	// A newer update of the same identifier supersedes one that's still in
+	// progress.  Receivers start over when they see the first chunk again.
+	for ( auto& p : pending_id_publishes )
+		if ( p.topic == topic && p.id == id )
+			{
+			p.chunker = std::move(chunker);
+			p.next_seq = 0;
+			return true;
+			}
+
+	pending_id_publishes.push_back({std::move(topic), std::move(id),
+	                                std::move(chunker)});
+	return true;
+	}
+
+void Manager::PublishPendingIdChunks(size_t max_chunks)
+	{
+	auto node = NodeID();
+
+	while ( max_chunks > 0 && ! pending_id_publishes.empty() )
+		{
+		auto& p = pending_id_publishes.front();
+
+		auto publish_chunk = [&](broker::data chunk, bool last)
+			{
+			broker::vector xs{broker::enum_value(ID_CHUNK_TAG), node,
+			                  p.next_seq++, last, std::move(chunk)};
+			broker::zeek::IdentifierUpdate msg(p.id, std::move(xs));
+			bstate->endpoint.publish(p.topic, msg.move_data());
+			};
+
+		broker::data chunk;
+
+		while ( max_chunks > 0 && p.chunker->Next(&chunk) )
+			{
+			publish_chunk(std::move(chunk), false);
+			--max_chunks;
+			}
+
+		if ( max_chunks == 0 )
+			// The chunker may well be done, but we'll find out next time.
+			break;
+
+		if ( p.chunker->Failed() )
+			{
+			// Let receivers drop what they have so far.
+			publish_chunk(broker::nil, true);
+			Error("Failed to publish ID with unsupported type: %s (%s)",
+			      p.id.c_str(), type_name(TYPE_TABLE));
+			}
+		else
+			{
+			if ( p.chunker->IsSet() )
+				publish_chunk(broker::set(), true);
+			else
+				publish_chunk(broker::table(), true);
+
+			++statistics.num_ids_outgoing;
+			}
+
+		pending_id_publishes.pop_front();
+		}
+	}
+
 bool Manager::PublishLogCreate(EnumVal* stream, EnumVal* writer,
 			       const logging::WriterBackend::WriterInfo& info,
 			       int num_fields, const threading::Field* const * fields,
@@ -930,6 +1179,10 @@ void Manager::Process()
 			}
 		}
 
+	// Spread publishing large identifiers over main-loop iterations.
+	PublishPendingIdChunks(id_chunks_per_iteration);
+	ExpirePendingIdUpdates();
+
 	if ( had_input )
 		{
 		if ( network_time == 0 )
@@ -940,6 +1193,11 @@ void Manager::Process()
 		}
 	}
 
+double Manager::GetNextTimeout()
+	{
+	// Come back right away while there are identifier chunks left to send.
+	return pending_id_publishes.empty() ? -1 : 0;
+	}
 
 void Manager::ProcessEvent(const broker::topic& topic, broker::zeek::Event ev)
 	{
@@ -953,6 +1211,12 @@ void Manager::ProcessEvent(const broker::topic& topic, broker::zeek::Event ev)
 	auto name = std::move(ev.name());
 	auto args = std::move(ev.args());
 
+	if ( name == "Broker::__table_sync" )
+		{
+		ProcessTableSync(topic.string(), args);
+		return;
+		}
+
 	DBG_LOG(DBG_BROKER, "Process event: %s %s",
 			name.data(), RenderMessage(args).data());
 	++statistics.num_events_incoming;
@@ -1184,7 +1448,6 @@ bool Manager::ProcessIdentifierUpdate(broker::zeek::IdentifierUpdate iu)
 		return false;
 		}
 
-	++statistics.num_ids_incoming;
 	auto id_name = std::move(iu.id_name());
 	auto id_value = std::move(iu.id_value());
 	auto id = global_scope()->Lookup(id_name);
@@ -1196,6 +1459,12 @@ bool Manager::ProcessIdentifierUpdate(broker::zeek::IdentifierUpdate iu)
 		return false;
 		}
 
+	// Chunks count towards the statistics once the last one is applied.
+	if ( id->Type()->Tag() == TYPE_TABLE && is_id_chunk(id_value) )
+		return ProcessIdentifierChunk(id, caf::get<broker::vector>(id_value));
+
+	++statistics.num_ids_incoming;
+
 	auto val = data_to_val(std::move(id_value), id->Type());
 
 	if ( ! val )
@@ -1209,6 +1478,99 @@ bool Manager::ProcessIdentifierUpdate(broker::zeek::IdentifierUpdate iu)
 	return true;
 	}
 
+bool Manager::ProcessIdentifierChunk(ID* id, broker::vector& chunk)
+	{
+	auto sender = caf::get_if<std::string>(&chunk[1]);
+	auto seq = caf::get_if<uint64_t>(&chunk[2]);
+	auto last = caf::get_if<bool>(&chunk[3]);
+
+	if ( ! sender || ! seq || ! last )
+		{
+		reporter->Warning("received invalid id-update chunk for %s", id->Name());
+		return false;
+		}
+
+	ExpirePendingIdUpdates();
+
+	// Transfers are tracked per sender so that concurrent updates of the
+	// same identifier from different nodes don't get mixed up.
+	auto key = pending_id_key{*sender, id->Name()};
+
+	if ( *seq == 0 )
+		{
+		auto& p = pending_id_updates[key];
+		p.next_seq = 0;
+		p.val = make_intrusive<TableVal>(
+			IntrusivePtr{NewRef{}, id->Type()->AsTableType()});
+		}
+
+	auto it = pending_id_updates.find(key);
+
+	if ( it == pending_id_updates.end() || *seq != it->second.next_seq )
+		{
+		reporter->Warning("received out-of-order id-update chunk for %s", id->Name());
+
+		if ( it != pending_id_updates.end() )
+			pending_id_updates.erase(it);
+
+		return false;
+		}
+
+	auto& pending = it->second;
+	++pending.next_seq;
+	pending.last_update = current_time(true);
+
+	if ( ! data_to_table_val(std::move(chunk[4]), pending.val.get()) )
+		{
+		if ( ! caf::get_if<broker::none>(&chunk[4]) )
+			reporter->Error("Failed to receive ID with unsupported type: %s (%s)",
+			                id->Name(), type_name(id->Type()->Tag()));
+
+		pending_id_updates.erase(it);
+		return false;
+		}
+
+	if ( *last )
+		{
+		id->SetVal(std::move(pending.val));
+		pending_id_updates.erase(it);
+		++statistics.num_ids_incoming;
+		}
+
+	return true;
+	}
+
+void Manager::ExpirePendingIdUpdates()
+	{
+	if ( pending_id_updates.empty() || id_chunk_timeout <= 0 )
+		return;
+
+	auto now = current_time(true);
+
+	for ( auto it = pending_id_updates.begin(); it != pending_id_updates.end(); )
+		{
+		if ( now - it->second.last_update > id_chunk_timeout )
+			{
+			reporter->Warning("dropping incomplete id-update for %s",
+			                  it->first.second.c_str());
+			it = pending_id_updates.erase(it);
+			}
+		else
+			++it;
+		}
+	}
+
+void Manager::DropPendingIdUpdates(const std::string& sender)
+	{
+	for ( auto it = pending_id_updates.begin(); it != pending_id_updates.end(); )
+		{
+		if ( it->first.first == sender )
+			it = pending_id_updates.erase(it);
+		else
+			++it;
+		}
+	}
+
 void Manager::ProcessStatus(broker::status stat)
 	{
 	DBG_LOG(DBG_BROKER, "Received status message: %s", RenderMessage(stat).c_str());
@@ -1225,16 +1587,25 @@ void Manager::ProcessStatus(broker::status stat)
 		++peer_count;
 		assert(ctx);
 		log_mgr->SendAllWritersTo(*ctx);
+		RequestTableSyncs(to_string(ctx->node));
 		event = Broker::peer_added;
 		break;
 
 	case broker::sc::peer_removed:
 		--peer_count;
+
+		if ( ctx )
+			DropPendingIdUpdates(to_string(ctx->node));
+
 		event = Broker::peer_removed;
 		break;
 
 	case broker::sc::peer_lost:
 		--peer_count;
+
+		if ( ctx )
+			DropPendingIdUpdates(to_string(ctx->node));
+
 		event = Broker::peer_lost;
 		break;
 
@@ -1370,6 +1741,19 @@ void Manager::ProcessStoreResponse(StoreHandleVal* s, broker::store::response re
 		return;
 		}
 
+	// The answer may predate a modification made through the handle
+	// while the query was in flight, in which case it's not cached.
+	if ( s->read_cache && request->second->CacheKey() &&
+	     request->second->CacheGeneration() == s->cache_generation )
+		{
+		auto key = request->second->CacheKey();
+
+		if ( response.answer )
+			s->read_cache->Insert(*key, true, *response.answer);
+		else if ( response.answer.error() == broker::ec::no_such_key )
+			s->read_cache->Insert(*key, false, broker::nil);
+		}
+
 	if ( request->second->Disabled() )
 		{
 		// Trigger timer must have timed the query out already.
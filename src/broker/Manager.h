@@ -13,21 +13,27 @@
 #include <broker/detail/hash.hh>
 #include <broker/zeek.hh>
 
+#include <deque>
 #include <memory>
 #include <string>
 #include <unordered_map>
 
+#include "IntrusivePtr.h"
+#include "Val.h"
 #include "iosource/IOSource.h"
 #include "logging/WriterBackend.h"
 
 class Frame;
 class Func;
+class ID;
 
 namespace bro_broker {
 
 class StoreHandleVal;
 class StoreQueryCallback;
 class BrokerState;
+class TableSync;
+class TableChunker;
 
 /**
  * Communication statistics.
@@ -43,6 +49,10 @@ struct Stats {
 	size_t num_events_incoming = 0;
 	// Number of total log messages sent.
 	size_t num_events_outgoing = 0;
+	// Number of event batches sent.
+	size_t num_event_batches_outgoing = 0;
+	// Number of event batches sent because they reached the size limit.
+	size_t num_event_batches_full = 0;
 	// Number of total log records received.
 	size_t num_logs_incoming = 0;
 	// Number of total log records sent.
@@ -316,6 +326,12 @@ public:
 	 */
 	size_t FlushLogBuffers();
 
+	/**
+	 * Send all pending batched event messages.
+	 * @return the number of events sent.
+	 */
+	size_t FlushEventBuffers();
+
 	/**
 	 * Flushes all pending data store queries and also clears all contents.
 	 */
@@ -326,6 +342,13 @@ public:
 	 */
 	const Stats& GetStatistics();
 
+	/**
+	 * Sends the changes made to tables with a &broker_sync attribute
+	 * since the last call.
+	 * @return the number of tables that had changes to send.
+	 */
+	size_t FlushTableSyncs();
+
 	/**
 	 * Creating an instance of this struct simply helps the manager
 	 * keep track of whether calls into its API are coming from script
@@ -343,6 +366,15 @@ private:
 	bool ProcessLogCreate(broker::zeek::LogCreate lc);
 	bool ProcessLogWrite(broker::zeek::LogWrite lw);
 	bool ProcessIdentifierUpdate(broker::zeek::IdentifierUpdate iu);
+	bool ProcessIdentifierChunk(ID* id, broker::vector& chunk);
+	bool PublishIdentifierChunks(std::string topic, std::string id, TableVal* t);
+	void PublishPendingIdChunks(size_t max_chunks);
+	void ExpirePendingIdUpdates();
+	void DropPendingIdUpdates(const std::string& sender);
+	void RegisterTableSyncs();
+	void ProcessTableSync(const std::string& topic, broker::vector& args);
+	void PublishTableSync(const std::string& topic, broker::vector msg);
+	void RequestTableSyncs(const std::string& peer);
 	void ProcessStatus(broker::status stat);
 	void ProcessError(broker::error err);
 	void ProcessStoreResponse(StoreHandleVal*, broker::store::response response);
@@ -354,7 +386,7 @@ private:
 	// IOSource interface overrides:
 	void Process() override;
 	const char* Tag() override	{ return "Broker::Manager"; }
-	double GetNextTimeout() override	{ return -1; }
+	double GetNextTimeout() override;
 
 	struct LogBuffer {
 		// Indexed by topic string.
@@ -364,6 +396,9 @@ private:
 		size_t Flush(broker::endpoint& endpoint, size_t batch_size);
 	};
 
+	// Sends the events buffered for a topic as a single batch message.
+	size_t FlushEventBuffer(const std::string& topic, broker::vector& batch);
+
 	// Data stores
 	using query_id = std::pair<broker::request_id, StoreHandleVal*>;
 
@@ -378,6 +413,7 @@ private:
 	};
 
 	std::vector<LogBuffer> log_buffers; // Indexed by stream ID enum.
+	std::unordered_map<std::string, broker::vector> event_buffers; // Indexed by topic.
 	std::string default_log_topic_prefix;
 	std::shared_ptr<BrokerState> bstate;
 	std::unordered_map<std::string, StoreHandleVal*> data_stores;
@@ -385,6 +421,41 @@ private:
 	                   query_id_hasher> pending_queries;
 	std::vector<std::string> forwarded_prefixes;
 
+	// A table identifier being published in chunks.
+	struct PendingIdPublish {
+		std::string topic;
+		std::string id;
+		std::unique_ptr<TableChunker> chunker;
+		uint64_t next_seq = 0;
+	};
+
+	// A table identifier being received in chunks.
+	struct PendingIdUpdate {
+		IntrusivePtr<TableVal> val;
+		uint64_t next_seq = 0;
+		double last_update = 0;
+	};
+
+	// Sending endpoint's node ID and identifier name.
+	using pending_id_key = std::pair<std::string, std::string>;
+
+	struct pending_id_key_hasher {
+		size_t operator()(const pending_id_key& key) const
+			{
+			size_t rval = 0;
+			broker::detail::hash_combine(rval, key.first);
+			broker::detail::hash_combine(rval, key.second);
+			return rval;
+			}
+	};
+
+	std::deque<PendingIdPublish> pending_id_publishes;
+	std::unordered_map<pending_id_key, PendingIdUpdate,
+	                   pending_id_key_hasher> pending_id_updates;
+
+	// Tables with a &broker_sync attribute, indexed by topic.
+	std::unordered_map<std::string, std::unique_ptr<TableSync>> table_syncs;
+
 	Stats statistics;
 
 	uint16_t bound_port;
@@ -393,6 +464,12 @@ private:
 	int peer_count;
 
 	size_t log_batch_size;
+	size_t event_batch_size;
+	size_t id_chunk_size;
+	size_t id_chunks_per_iteration;
+	double id_chunk_timeout;
+	size_t table_sync_history;
+	double table_sync_interval;
 	Func* log_topic_func;
 	VectorType* vector_of_data_type;
 	EnumType* log_id_type;
@@ -23,6 +23,68 @@ EnumVal* query_status(bool success)
 	return store_query_status->GetVal(success ? success_val : failure_val).release();
 	}
 
+StoreReadCache::StoreReadCache(double arg_ttl, size_t arg_max_entries)
+	: ttl(arg_ttl), max_entries(arg_max_entries), hits(0), misses(0)
+	{
+	}
+
+const StoreReadCache::Entry* StoreReadCache::Lookup(const broker::data& key)
+	{
+	auto it = entries.find(key);
+
+	if ( it == entries.end() )
+		{
+		++misses;
+		return nullptr;
+		}
+
+	if ( it->second->expire_time <= network_time )
+		{
+		lru.erase(it->second);
+		entries.erase(it);
+		++misses;
+		return nullptr;
+		}
+
+	++hits;
+	lru.splice(lru.begin(), lru, it->second);
+	return &*it->second;
+	}
+
+void StoreReadCache::Insert(broker::data key, bool found, broker::data value)
+	{
+	Invalidate(key);
+
+	if ( max_entries == 0 )
+		return;
+
+	lru.push_front({key, found, std::move(value), network_time + ttl});
+	entries.emplace(std::move(key), lru.begin());
+
+	while ( entries.size() > max_entries )
+		{
+		entries.erase(lru.back().key);
+		lru.pop_back();
+		}
+	}
+
+void StoreReadCache::Invalidate(const broker::data& key)
+	{
+	auto it = entries.find(key);
+
+	if ( it == entries.end() )
+		return;
+
+	lru.erase(it->second);
+	entries.erase(it);
+	}
+
+void StoreReadCache::Clear()
+	{
+	entries.clear();
+	lru.clear();
+	}
+
 void StoreHandleVal::ValDescribe(ODesc* d) const
 	{
 	//using BifEnum::Broker::BackendType;
@@ -9,6 +9,10 @@
 #include <broker/backend.hh>
 #include <broker/backend_options.hh>
 
+#include <list>
+#include <memory>
+#include <unordered_map>
+
 namespace bro_broker {
 
 extern OpaqueType* opaque_of_store_handle;
@@ -81,11 +85,103 @@ public:
 	const broker::store& Store() const
 		{ return store; }
 
+	/**
+	 * Marks the query as a lookup of the given key whose answer may be
+	 * added to the store handle's read cache.
+	 * @param key the key looked up.
+	 * @param generation the handle's cache generation when the query
+	 * started.  If it's changed by the time the answer arrives, the
+	 * answer may be stale and doesn't get cached.
+	 */
+	void SetCacheKey(broker::data key, uint64_t generation)
+		{
+		cache_key = std::make_unique<broker::data>(std::move(key));
+		cache_generation = generation;
+		}
+
+	/**
+	 * @return the key set via SetCacheKey(), or nullptr if none.
+	 */
+	const broker::data* CacheKey() const
+		{ return cache_key.get(); }
+
+	/**
+	 * @return the generation set via SetCacheKey().
+	 */
+	uint64_t CacheGeneration() const
+		{ return cache_generation; }
+
 private:
 
 	trigger::Trigger* trigger;
 	const CallExpr* call;
 	broker::store store;
+	std::unique_ptr<broker::data> cache_key;
+	uint64_t cache_generation = 0;
+};
+
+/**
+ * A local cache of the answers to recent lookups in a data store, so that
+ * repeated lookups of the same key can be answered without a round trip
+ * to the store's master.  Entries expire a fixed time after they were
+ * added.  Modifications made through the same handle invalidate the
+ * affected keys, those made elsewhere become visible once the entry has
+ * expired.
+ */
+class StoreReadCache {
+public:
+	/**
+	 * Constructor.
+	 * @param ttl the time after which entries expire.
+	 * @param max_entries the max number of keys to cache.  If it's
+	 * reached, the least recently used entry is removed.
+	 */
+	StoreReadCache(double ttl, size_t max_entries);
+
+	/**
+	 * A cached answer.
+	 */
+	struct Entry {
+		broker::data key;
+		bool found;	// False if the store had no such key.
+		broker::data value;
+		double expire_time;
+	};
+
+	/**
+	 * Looks up the cached answer for a key.
+	 * @return the entry, or nullptr if the key isn't cached or expired.
+	 */
+	const Entry* Lookup(const broker::data& key);
+
+	/**
+	 * Adds or replaces the answer for a key.
+	 */
+	void Insert(broker::data key, bool found, broker::data value);
+
+	/**
+	 * Removes a key from the cache.
+	 */
+	void Invalidate(const broker::data& key);
+
+	/**
+	 * Removes all keys from the cache.
+	 */
+	void Clear();
+
+	uint64_t Hits() const	{ return hits; }
+	uint64_t Misses() const	{ return misses; }
+	size_t Size() const	{ return entries.size(); }
+
+private:
+	typedef std::list<Entry> EntryList;
+
+	double ttl;
+	size_t max_entries;
+	EntryList lru;	// Most recently used first.
+	std::unordered_map<broker::data, EntryList::iterator> entries;
+	uint64_t hits;
+	uint64_t misses;
 };
 
 /**
@@ -99,8 +195,38 @@ public:
 
 	void ValDescribe(ODesc* d) const override;
 
+	/**
+	 * Removes a key from the read cache, if there is one.  Called for all
+	 * modifications made through this handle.
+	 */
+	void InvalidateCache(const broker::data& key)
+		{
+		if ( read_cache )
+			{
+			read_cache->Invalidate(key);
+			++cache_generation;
+			}
+		}
+
+	/**
+	 * Removes all keys from the read cache, if there is one.
+	 */
+	void ClearCache()
+		{
+		if ( read_cache )
+			{
+			read_cache->Clear();
+			++cache_generation;
+			}
+		}
+
 	broker::store store;
 	broker::store::proxy proxy;
+	std::unique_ptr<StoreReadCache> read_cache;
+
+	// Changes with every invalidation, so that answers to lookups that
+	// were in flight meanwhile don't get cached.
+	uint64_t cache_generation = 0;
 
 protected:
 	StoreHandleVal()
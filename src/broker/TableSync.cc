@@ -0,0 +1,409 @@
+// See the file "COPYING" in the main distribution directory for copyright.
+
+#include "TableSync.h"
+#include "Data.h"
+#include "Manager.h"
+
+#include "Dict.h"
+#include "Hash.h"
+#include "ID.h"
+#include "Net.h"
+#include "Reporter.h"
+
+using namespace bro_broker;
+
+TableSync::TableSync(ID* arg_id, std::string arg_topic, std::string arg_node,
+                     size_t arg_max_history)
+	: id(NewRef{}, arg_id), topic(std::move(arg_topic)),
+	  node(std::move(arg_node)), max_history(arg_max_history)
+	{
+	Bind();
+	}
+
+TableSync::~TableSync()
+	{
+	if ( table )
+		table->SetElementObserver(nullptr);
+	}
+
+void TableSync::Bind()
+	{
+	if ( table )
+		{
+		// Elements of the old value that the new one lacks count
+		// as removed.
+		table->SetElementObserver(nullptr);
+		TouchAll(table.get(), false);
+		table = nullptr;
+		}
+
+	owners.clear();
+
+	auto v = id->ID_Val();
+
+	if ( ! v || v->Type()->Tag() != TYPE_TABLE )
+		return;
+
+	table = {NewRef{}, v->AsTableVal()};
+	table->SetElementObserver(this);
+
+	// Whatever the table holds already hasn't been shipped yet.
+	TouchAll(table.get(), true);
+	}
+
+void TableSync::TouchAll(TableVal* t, bool owned)
+	{
+	const PDict<TableEntryVal>* tbl = t->AsTable();
+	IterCookie* c = tbl->InitForIteration();
+	HashKey* k;
+
+	while ( tbl->NextEntry(k, c) )
+		{
+		std::string key_bytes(static_cast<const char*>(k->Key()), k->Size());
+
+		if ( owned )
+			owners[key_bytes] = &node;
+
+		auto& p = pending[key_bytes];
+
+		if ( p )
+			delete k;
+		else
+			p.reset(k);
+		}
+	}
+
+void TableSync::ElementModified(TableVal* t, const HashKey* k, bool removed)
+	{
+	if ( applying || t != table.get() )
+		return;
+
+	std::string key_bytes(static_cast<const char*>(k->Key()), k->Size());
+
+	if ( removed )
+		owners.erase(key_bytes);
+	else
+		owners[key_bytes] = &node;
+
+	auto& p = pending[key_bytes];
+
+	// The element's current state is looked up when flushing, so all
+	// that's needed here is to remember its key once.
+	if ( ! p )
+		p.reset(new HashKey(k->Key(), k->Size(), k->Hash()));
+	}
+
+bool TableSync::AddOp(const HashKey* k, broker::vector* ops)
+	{
+	auto key = index_to_data(table.get(), k);
+
+	if ( ! key )
+		{
+		reporter->Error("failed to convert index of synchronized table %s",
+		                id->Name());
+		return false;
+		}
+
+	auto entry = table->AsTable()->Lookup(k);
+
+	if ( ! entry )
+		{
+		ops->emplace_back(broker::vector{true, std::move(*key), broker::data{}});
+		return true;
+		}
+
+	broker::data value;
+
+	if ( ! table->Type()->IsSet() )
+		{
+		auto v = val_to_data(entry->Value());
+
+		if ( ! v )
+			{
+			reporter->Error("failed to convert value of synchronized table %s",
+			                id->Name());
+			return false;
+			}
+
+		value = std::move(*v);
+		}
+
+	ops->emplace_back(broker::vector{false, std::move(*key), std::move(value)});
+	return true;
+	}
+
+broker::vector TableSync::Flush()
+	{
+	if ( id->ID_Val() != table.get() )
+		Bind();
+
+	if ( ! table || pending.empty() )
+		return {};
+
+	broker::vector ops;
+	ops.reserve(pending.size());
+
+	for ( const auto& p : pending )
+		AddOp(p.second.get(), &ops);
+
+	pending.clear();
+
+	if ( ops.empty() )
+		return {};
+
+	broker::vector msg{broker::count(DELTA), node, broker::count(++seq),
+	                   std::move(ops)};
+
+	if ( max_history > 0 )
+		{
+		history.emplace_back(seq, msg);
+
+		while ( history.size() > max_history )
+			history.pop_front();
+		}
+
+	return msg;
+	}
+
+broker::vector TableSync::Request(const std::string& target) const
+	{
+	auto it = versions.find(target);
+	broker::count have = it != versions.end() ? it->second : 0;
+
+	broker::table vv;
+	vv.emplace(target, have);
+
+	return {broker::count(REQUEST), node, broker::count(0), std::move(vv)};
+	}
+
+bool TableSync::Apply(broker::vector& ops, const std::string* origin,
+                      std::unordered_set<std::string>* seen)
+	{
+	auto tt = table->Type()->AsTableType();
+	bool rval = true;
+
+	applying = true;
+
+	for ( auto& op_data : ops )
+		{
+		auto op = caf::get_if<broker::vector>(&op_data);
+
+		if ( ! op || op->size() != 3 )
+			{
+			rval = false;
+			continue;
+			}
+
+		auto removed = caf::get_if<bool>(&(*op)[0]);
+		auto index = removed ? data_to_index_val((*op)[1], tt) : nullptr;
+
+		if ( ! index )
+			{
+			rval = false;
+			continue;
+			}
+
+		std::unique_ptr<HashKey> k(table->ComputeHash(index.get()));
+
+		if ( ! k )
+			{
+			rval = false;
+			continue;
+			}
+
+		std::string key_bytes(static_cast<const char*>(k->Key()), k->Size());
+
+		if ( *removed )
+			{
+			owners.erase(key_bytes);
+
+			if ( table->AsTable()->Lookup(k.get()) )
+				table->Delete(k.get());
+
+			continue;
+			}
+
+		if ( tt->IsSet() )
+			table->Assign(index.get(), nullptr);
+
+		else
+			{
+			auto v = data_to_val(std::move((*op)[2]), tt->YieldType());
+
+			if ( ! v )
+				{
+				rval = false;
+				continue;
+				}
+
+			table->Assign(index.get(), std::move(v));
+			}
+
+		owners[key_bytes] = origin;
+
+		if ( seen )
+			seen->insert(std::move(key_bytes));
+		}
+
+	applying = false;
+	return rval;
+	}
+
+void TableSync::RemoveMissing(const std::string* origin,
+                              const std::unordered_set<std::string>& seen)
+	{
+	applying = true;
+
+	for ( auto it = owners.begin(); it != owners.end(); )
+		{
+		if ( it->second != origin || seen.count(it->first) )
+			{
+			++it;
+			continue;
+			}
+
+		HashKey k(it->first.data(), it->first.size());
+		it = owners.erase(it);
+		table->Delete(&k);
+		}
+
+	applying = false;
+	}
+
+broker::vector TableSync::Snapshot()
+	{
+	broker::vector ops;
+
+	const PDict<TableEntryVal>* tbl = table->AsTable();
+	IterCookie* c = tbl->InitForIteration();
+	HashKey* k;
+
+	while ( tbl->NextEntry(k, c) )
+		{
+		std::string key_bytes(static_cast<const char*>(k->Key()), k->Size());
+		auto it = owners.find(key_bytes);
+
+		// Others answer for the elements they set.
+		if ( it != owners.end() && it->second == &node )
+			AddOp(k, &ops);
+
+		delete k;
+		}
+
+	return {broker::count(SNAPSHOT), node, broker::count(seq), std::move(ops)};
+	}
+
+bool TableSync::Process(broker::vector& msg, std::vector<broker::vector>* replies)
+	{
+	if ( msg.size() != 4 )
+		return false;
+
+	auto kind = caf::get_if<broker::count>(&msg[0]);
+	auto origin = caf::get_if<std::string>(&msg[1]);
+	auto msg_seq = caf::get_if<broker::count>(&msg[2]);
+
+	if ( ! (kind && origin && msg_seq) )
+		return false;
+
+	if ( *origin == node )
+		return true;
+
+	if ( id->ID_Val() != table.get() )
+		Bind();
+
+	if ( ! table )
+		return false;
+
+	switch ( *kind ) {
+	case DELTA:
+	case SNAPSHOT:
+		{
+		auto ops = caf::get_if<broker::vector>(&msg[3]);
+
+		if ( ! ops )
+			return false;
+
+		auto vit = versions.emplace(*origin, 0).first;
+		auto& last = vit->second;
+
+		if ( *msg_seq <= last )
+			// Already applied, e.g. replayed for another node.
+			return true;
+
+		if ( *kind == DELTA && *msg_seq != last + 1 )
+			{
+			// Missed something.  The origin's answer will include
+			// this delta again, so don't apply it out of order.
+			if ( outstanding.insert(*origin).second )
+				replies->emplace_back(Request(*origin));
+
+			return true;
+			}
+
+		last = *msg_seq;
+		outstanding.erase(*origin);
+
+		if ( *kind == DELTA )
+			return Apply(*ops, &vit->first, nullptr);
+
+		// Elements the origin set before that aren't part of its
+		// snapshot have been deleted there since.
+		std::unordered_set<std::string> seen;
+		bool rval = Apply(*ops, &vit->first, &seen);
+		RemoveMissing(&vit->first, seen);
+		return rval;
+		}
+
+	case REQUEST:
+		{
+		auto vv = caf::get_if<broker::table>(&msg[3]);
+
+		if ( ! vv )
+			return false;
+
+		auto it = vv->find(node);
+
+		if ( it == vv->end() )
+			// Asking someone else.
+			return true;
+
+		auto c = caf::get_if<broker::count>(&it->second);
+
+		if ( ! c )
+			return false;
+
+		uint64_t have = *c;
+
+		if ( have >= seq )
+			return true;
+
+		if ( ! history.empty() && history.front().first <= have + 1 )
+			{
+			for ( const auto& h : history )
+				if ( h.first > have )
+					replies->emplace_back(h.second);
+
+			return true;
+			}
+
+		replies->emplace_back(Snapshot());
+		return true;
+		}
+
+	default:
+		return false;
+	}
+	}
+
+TableSyncTimer::TableSyncTimer(double t, double arg_interval)
+	: Timer(t, TIMER_TABLE_SYNC), interval(arg_interval)
+	{
+	}
+
+void TableSyncTimer::Dispatch(double t, bool is_expire)
+	{
+	broker_mgr->FlushTableSyncs();
+
+	if ( ! is_expire )
+		timer_mgr->Add(new TableSyncTimer(network_time + interval, interval));
+	}
@@ -0,0 +1,177 @@
+// See the file "COPYING" in the main distribution directory for copyright.
+
+#pragma once
+
+#include <broker/data.hh>
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "IntrusivePtr.h"
+#include "Timer.h"
+#include "Val.h"
+
+class ID;
+
+namespace bro_broker {
+
+/**
+ * Keeps a global table with a &broker_sync attribute in sync with the
+ * same table on other nodes subscribed to the attribute's topic.
+ *
+ * Local modifications are recorded per element and shipped periodically
+ * as a single delta message that holds the current state of every element
+ * changed since the previous one, so repeated updates of the same element
+ * only ever cost one entry.  Each node numbers the deltas it originates,
+ * and receivers keep a version vector of the last delta they applied per
+ * originating node.  When a receiver notices a gap (e.g. because it just
+ * started or reconnected), it asks the node whose deltas it missed to
+ * replay them from a bounded history, or to send a snapshot of the
+ * elements it originated if the history doesn't reach back far enough.
+ *
+ * To apply such a snapshot, each node remembers which node last set each
+ * element: elements a snapshot's originating node set before but that
+ * the snapshot lacks have since been deleted there.  This costs one
+ * additional copy of each element's key.
+ */
+class TableSync final : public TableElementObserver {
+public:
+	/**
+	 * Message kinds, the first element of each synchronization message.
+	 */
+	enum MessageKind {
+		DELTA = 0,	//! [kind, origin, seq, ops]
+		SNAPSHOT = 1,	//! [kind, origin, seq, ops]
+		REQUEST = 2,	//! [kind, requester, 0, {target -> seq}]
+	};
+
+	/**
+	 * Constructor.
+	 * @param id the global table identifier to keep in sync.
+	 * @param topic the topic to exchange synchronization messages on.
+	 * @param node the ID of the local Broker endpoint.
+	 * @param max_history the number of locally originated deltas to keep
+	 * for answering catch-up requests.
+	 */
+	TableSync(ID* id, std::string topic, std::string node, size_t max_history);
+
+	/**
+	 * Destructor.
+	 */
+	~TableSync() override;
+
+	/**
+	 * @return the topic synchronization messages are exchanged on.
+	 */
+	const std::string& Topic() const	{ return topic; }
+
+	/**
+	 * Returns a delta message covering all elements modified since the
+	 * last call, and records it in the history.
+	 * @return the message, or an empty vector if nothing changed.
+	 */
+	broker::vector Flush();
+
+	/**
+	 * Returns a message asking a node for the deltas it originated that
+	 * are missing locally.  Only that node answers.
+	 * @param target the ID of the Broker endpoint to ask.
+	 */
+	broker::vector Request(const std::string& target) const;
+
+	/**
+	 * Processes a synchronization message received from another node.
+	 * @param msg the message.
+	 * @param replies any messages to publish in response get added here.
+	 * @return false if the message was malformed.
+	 */
+	bool Process(broker::vector& msg, std::vector<broker::vector>* replies);
+
+	/**
+	 * Forgets about catch-up requests that are still outstanding, e.g.
+	 * because a new peering may have made them unanswerable.
+	 */
+	void ResetRequests()	{ outstanding.clear(); }
+
+	void ElementModified(TableVal* t, const HashKey* k, bool removed) override;
+
+private:
+	// Starts observing the identifier's current table value.
+	void Bind();
+
+	// Marks all elements of the given table as modified, and if owned
+	// is true, as originating locally.
+	void TouchAll(TableVal* t, bool owned);
+
+	// Applies the operations of a delta or snapshot message from the
+	// given node.  If seen is non-null, adds the key bytes of the
+	// elements the message sets to it.
+	bool Apply(broker::vector& ops, const std::string* origin,
+	           std::unordered_set<std::string>* seen);
+
+	// Removes the elements last set by the given node that are missing
+	// from a snapshot it sent.
+	void RemoveMissing(const std::string* origin,
+	                   const std::unordered_set<std::string>& seen);
+
+	// Returns a snapshot of the elements originating locally.
+	broker::vector Snapshot();
+
+	// Builds the operation for a single element.
+	bool AddOp(const HashKey* k, broker::vector* ops);
+
+	IntrusivePtr<ID> id;
+	IntrusivePtr<TableVal> table;
+	std::string topic;
+	std::string node;
+	size_t max_history;
+
+	// Sequence number of the last delta originated locally.
+	uint64_t seq = 0;
+
+	// Modified elements since the last flush, indexed by key bytes.
+	std::unordered_map<std::string, std::unique_ptr<HashKey>> pending;
+
+	// Recent locally originated deltas, oldest first.
+	std::deque<std::pair<uint64_t, broker::vector>> history;
+
+	// Last sequence number applied, indexed by originating node.
+	std::map<std::string, uint64_t> versions;
+
+	// Originating nodes asked for a catch-up that hasn't arrived yet.
+	std::set<std::string> outstanding;
+
+	// The node that last set each element, indexed by key bytes.  The
+	// names point to the node member or to keys of the versions map.
+	std::unordered_map<std::string, const std::string*> owners;
+
+	// True while applying remote changes, which must not be recorded.
+	bool applying = false;
+};
+
+/**
+ * Periodically flushes the pending changes of all synchronized tables.
+ */
+class TableSyncTimer final : public Timer {
+public:
+	/**
+	 * Constructor.
+	 * @param t the time at which to flush.
+	 * @param interval the time between subsequent flushes.
+	 */
+	TableSyncTimer(double t, double interval);
+
+protected:
+	void Dispatch(double t, bool is_expire) override;
+
+	double interval;
+};
+
+} // namespace bro_broker
@@ -85,6 +85,7 @@ File::File(const std::string& file_id, const std::string& source_name, Connectio
 	: id(file_id), val(nullptr), file_reassembler(nullptr), stream_offset(0),
 	  reassembly_max_buffer(0), did_metadata_inference(false),
 	  reassembly_enabled(false), postpone_timeout(false), done(false),
+	  dedup_checked(false), duplicate(false), dedup_analysis_time(0),
 	  analyzers(this)
 	{
 	StaticInit();
@@ -260,6 +261,9 @@ bool File::AddAnalyzer(file_analysis::Tag tag, RecordVal* args)
 	if ( done )
 		return false;
 
+	if ( duplicate && file_mgr->IsDedupSkipped(tag) )
+		return false;
+
 	return analyzers.QueueAdd(tag, args) != nullptr;
 	}
 
@@ -315,12 +319,12 @@ void File::InferMetadata()
 
 	if ( ! bof_buffer_val )
 		{
-		if ( bof_buffer.size == 0 )
+		bof_buffer_val = BOFBufferVal();
+
+		if ( ! bof_buffer_val )
 			return;
 
-		BroString* bs = concatenate(bof_buffer.chunks);
-		bof_buffer_val = new StringVal(bs);
-		val->Assign(bof_buffer_idx, bof_buffer_val);
+		val->Assign(bof_buffer_idx, {NewRef{}, bof_buffer_val});
 		}
 
 	if ( ! FileEventAvailable(file_sniff) )
@@ -345,6 +349,26 @@ void File::InferMetadata()
 	FileEvent(file_sniff, {IntrusivePtr{NewRef{}, val}, std::move(meta)});
 	}
 
+File::BOF_Buffer::~BOF_Buffer()
+	{
+	if ( val )
+		Unref(val);
+	else
+		delete [] data;
+	}
+
+StringVal* File::BOFBufferVal()
+	{
+	if ( ! bof_buffer.val && bof_buffer.size > 0 )
+		{
+		// There's always room for the trailing NUL, see BufferBOF().
+		bof_buffer.data[bof_buffer.size] = '\0';
+		bof_buffer.val = new StringVal(new BroString(true, bof_buffer.data, bof_buffer.size));
+		}
+
+	return bof_buffer.val;
+	}
+
 bool File::BufferBOF(const u_char* data, uint64_t len)
 	{
 	if ( bof_buffer.full )
@@ -352,7 +376,26 @@ bool File::BufferBOF(const u_char* data, uint64_t len)
 
 	uint64_t desired_size = LookupFieldDefaultCount(bof_buffer_size_idx);
 
-	bof_buffer.chunks.push_back(new BroString(data, len, false));
+	if ( bof_buffer.size + len + 1 > bof_buffer.capacity )
+		{
+		// Buffer into a single contiguous allocation that the
+		// bof_buffer string value can adopt once we're done.
+		uint64_t new_capacity = std::max(bof_buffer.size + len + 1,
+		                                 std::min(bof_buffer.capacity * 2,
+		                                          desired_size + 1));
+		u_char* new_data = new u_char[new_capacity];
+
+		if ( bof_buffer.size > 0 )
+			memcpy(new_data, bof_buffer.data, bof_buffer.size);
+
+		delete [] bof_buffer.data;
+		bof_buffer.data = new_data;
+		bof_buffer.capacity = new_capacity;
+		}
+
+	if ( len > 0 )
+		memcpy(bof_buffer.data + bof_buffer.size, data, len);
+
 	bof_buffer.size += len;
 
 	if ( bof_buffer.size < desired_size )
@@ -361,10 +404,7 @@ bool File::BufferBOF(const u_char* data, uint64_t len)
 	bof_buffer.full = true;
 
 	if ( bof_buffer.size > 0 )
-		{
-		BroString* bs = concatenate(bof_buffer.chunks);
-		val->Assign(bof_buffer_idx, make_intrusive<StringVal>(bs));
-		}
+		val->Assign(bof_buffer_idx, {NewRef{}, BOFBufferVal()});
 
 	return false;
 	}
@@ -375,6 +415,14 @@ void File::DeliverStream(const u_char* data, uint64_t len)
 	// Buffer enough data for the BOF buffer
 	BufferBOF(data, len);
 
+	if ( ! dedup_checked && bof_buffer.full )
+		{
+		// Check before metadata inference, so that analyzers attached
+		// based on the MIME type are already subject to skipping.
+		dedup_checked = true;
+		file_mgr->CheckDuplicate(this);
+		}
+
 	if ( ! did_metadata_inference && bof_buffer.full &&
 	     LookupFieldDefaultCount(missing_bytes_idx) == 0 )
 		InferMetadata();
@@ -395,29 +443,21 @@ void File::DeliverStream(const u_char* data, uint64_t len)
 		if ( ! a->GotStreamDelivery() )
 			{
 			DBG_LOG(DBG_FILE_ANALYSIS, "skipping stream delivery to analyzer %s", file_mgr->GetComponentName(a->Tag()).c_str());
-			int num_bof_chunks_behind = bof_buffer.chunks.size();
+			uint64_t bof_bytes_behind = bof_buffer.size;
 
 			if ( ! bof_was_full )
-				// We just added a chunk to the BOF buffer, don't count it
-				// as it will get delivered on its own.
-				num_bof_chunks_behind -= 1;
-
-			uint64_t bytes_delivered = 0;
+				// We just added this chunk to the BOF buffer, don't count
+				// it as it will get delivered on its own.
+				bof_bytes_behind -= len;
 
 			// Catch this analyzer up with the BOF buffer.
-			for ( int i = 0; i < num_bof_chunks_behind; ++i )
+			if ( bof_bytes_behind > 0 && ! a->Skipping() )
 				{
-				if ( ! a->Skipping() )
+				if ( ! a->DeliverStream(bof_buffer.data, bof_bytes_behind) )
 					{
-					if ( ! a->DeliverStream(bof_buffer.chunks[i]->Bytes(),
-								bof_buffer.chunks[i]->Len()) )
-						{
-						a->SetSkip(true);
-						analyzers.QueueRemove(a->Tag(), a->Args());
-						}
+					a->SetSkip(true);
+					analyzers.QueueRemove(a->Tag(), a->Args());
 					}
-
-				bytes_delivered += bof_buffer.chunks[i]->Len();
 				}
 
 			a->SetGotStreamDelivery();
@@ -427,11 +467,17 @@ void File::DeliverStream(const u_char* data, uint64_t len)
 
 		if ( ! a->Skipping() )
 			{
+			bool timed = ! dedup_key.empty() && file_mgr->IsDedupSkipped(a->Tag());
+			double start = timed ? current_time(true) : 0;
+
 			if ( ! a->DeliverStream(data, len) )
 				{
 				a->SetSkip(true);
 				analyzers.QueueRemove(a->Tag(), a->Args());
 				}
+
+			if ( timed )
+				dedup_analysis_time += current_time(true) - start;
 			}
 		}
 
@@ -461,8 +507,11 @@ void File::DeliverChunk(const u_char* data, uint64_t len, uint64_t offset)
 				}
 			}
 
-		// Forward data to the reassembler.
-		file_reassembler->NewBlock(network_time, offset, len, data);
+		// Data continuing right where the stream left off doesn't need
+		// to be buffered by the reassembler if nothing else is pending.
+		if ( ! file_reassembler->DeliverInOrder(offset, len, data) )
+			// Forward data to the reassembler.
+			file_reassembler->NewBlock(network_time, offset, len, data);
 		}
 	else if ( stream_offset == offset )
 		{
@@ -559,8 +608,14 @@ void File::EndOfFile()
 
 	while ( (a = analyzers.NextEntry(c)) )
 		{
+		bool timed = ! dedup_key.empty() && file_mgr->IsDedupSkipped(a->Tag());
+		double start = timed ? current_time(true) : 0;
+
 		if ( ! a->EndOfFile() )
 			analyzers.QueueRemove(a->Tag(), a->Args());
+
+		if ( timed )
+			dedup_analysis_time += current_time(true) - start;
 		}
 
 	FileEvent(file_state_remove);
@@ -640,7 +695,7 @@ void File::FileEvent(EventHandlerPtr h, zeek::Args args)
 	mgr.Enqueue(h, std::move(args));
 
 	if ( h == file_new || h == file_over_new_connection ||
-	     h == file_sniff ||
+	     h == file_sniff || h == file_duplicate ||
 	     h == file_timeout || h == file_extraction_limit )
 		{
 		// immediate feedback is required for these events.
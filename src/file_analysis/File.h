@@ -16,6 +16,7 @@
 class Connection;
 class RecordType;
 class RecordVal;
+class StringVal;
 class EventHandlerPtr;
 
 namespace file_analysis {
@@ -339,17 +340,32 @@ protected:
 	bool reassembly_enabled;           /**< Whether file stream reassembly is needed. */
 	bool postpone_timeout;     /**< Whether postponing timeout is requested. */
 	bool done;                 /**< If this object is about to be deleted. */
+	bool dedup_checked;        /**< Whether the duplicate cache has been consulted. */
+	bool duplicate;            /**< Whether the file repeats a recently seen one. */
+	std::string dedup_key;     /**< Duplicate cache key if this file created the entry. */
+	double dedup_analysis_time; /**< Time spent in analyzers skippable for duplicates. */
 	AnalyzerSet analyzers;     /**< A set of attached file analyzers. */
 	std::list<Analyzer *> done_analyzers; /**< Analyzers we're done with, remembered here until they can be safely deleted. */
 
+	/**
+	 * Returns the BOF buffer as a string value, creating it on first use.
+	 * The value takes over the buffered bytes rather than copying them,
+	 * and is shared between the \c bof_buffer field of #val and the
+	 * catch-up delivery to analyzers added later on.
+	 * @return the BOF buffer value, or a null pointer if nothing has been
+	 * buffered.
+	 */
+	StringVal* BOFBufferVal();
+
 	struct BOF_Buffer {
-		BOF_Buffer() : full(false), size(0) {}
-		~BOF_Buffer()
-			{ for ( size_t i = 0; i < chunks.size(); ++i ) delete chunks[i]; }
+		BOF_Buffer() : full(false), size(0), capacity(0), data(nullptr), val(nullptr) {}
+		~BOF_Buffer();
 
 		bool full;
 		uint64_t size;
-		BroString::CVec chunks;
+		uint64_t capacity;
+		u_char* data;      /**< Contiguous buffered bytes; owned by #val once that exists. */
+		StringVal* val;    /**< Immutable string value adopting #data. */
 	} bof_buffer;              /**< Beginning of file buffer. */
 
 	WeirdStateMap weird_state;
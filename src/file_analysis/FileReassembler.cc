@@ -50,6 +50,17 @@ uint64_t FileReassembler::FlushTo(uint64_t sequence)
 	return rval;
 	}
 
+bool FileReassembler::DeliverInOrder(uint64_t seq, uint64_t len, const u_char* data)
+	{
+	if ( flushing || len == 0 || HasBlocks() || seq != last_reassem_seq )
+		return false;
+
+	last_reassem_seq += len;
+	SetTrimSeq(last_reassem_seq);
+	the_file->DeliverStream(data, len);
+	return true;
+	}
+
 void FileReassembler::BlockInserted(DataBlockMap::const_iterator it)
 	{
 	const auto& start_block = it->second;
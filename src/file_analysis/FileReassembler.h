@@ -38,6 +38,19 @@ public:
 	 */
 	uint64_t FlushTo(uint64_t sequence);
 
+	/**
+	 * Passes a block straight through to File::DeliverStream() without
+	 * copying it into the reassembly buffer, which is possible if it
+	 * starts exactly where the stream left off and nothing else is
+	 * currently buffered.
+	 * @param seq the file offset at which the block starts.
+	 * @param len the number of bytes in the block.
+	 * @param data pointer to the block's data.
+	 * @return true if the block was delivered, false if it needs to go
+	 * through NewBlock() instead.
+	 */
+	bool DeliverInOrder(uint64_t seq, uint64_t len, const u_char* data);
+
 	/**
 	 * @return whether the reassembler is currently is the process of flushing
 	 * out the contents of its buffer.
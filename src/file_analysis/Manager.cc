@@ -20,8 +20,10 @@ using namespace std;
 Manager::Manager()
 	: plugin::ComponentManager<file_analysis::Tag,
 	                           file_analysis::Component>("Files", "Tag"),
-	  current_file_id(), magic_state(), cumulative_files(0), max_files(0)
+	  current_file_id(), magic_state(), cumulative_files(0), max_files(0),
+	  dedup_max_entries(0)
 	{
+	dedup_stats = {};
 	}
 
 Manager::~Manager()
@@ -43,6 +45,17 @@ void Manager::InitPreScript()
 
 void Manager::InitPostScript()
 	{
+	dedup_max_entries = opt_internal_unsigned("Files::dedup_cache_size");
+
+	if ( auto skip = opt_internal_val("Files::dedup_skip_analyzers") )
+		{
+		ListVal* tags = skip->AsTableVal()->ConvertToPureList();
+
+		for ( int i = 0; i < tags->Length(); ++i )
+			dedup_skip.insert(file_analysis::Tag(tags->Index(i)->AsEnumVal()));
+
+		Unref(tags);
+		}
 	}
 
 void Manager::InitMagic()
@@ -397,6 +410,7 @@ bool Manager::RemoveFile(const string& file_id)
 	DBG_LOG(DBG_FILE_ANALYSIS, "[%s] Remove file", file_id.c_str());
 
 	f->EndOfFile();
+	FinishDuplicateCheck(f);
 	delete f;
 
 	id_map.erase(file_id);
@@ -404,6 +418,84 @@ bool Manager::RemoveFile(const string& file_id)
 	return true;
 	}
 
+bool Manager::CheckDuplicate(File* f)
+	{
+	if ( ! dedup_max_entries || f->bof_buffer.size == 0 )
+		return false;
+
+	Val* total = f->val->Lookup(File::total_bytes_idx);
+
+	if ( ! total )
+		return false;
+
+	uint64_t size = total->AsCount();
+	hash128_t h;
+	KeyedHash::StaticHash128(f->bof_buffer.data, f->bof_buffer.size, &h);
+
+	string key(reinterpret_cast<const char*>(&h), sizeof(h));
+	key.append(reinterpret_cast<const char*>(&size), sizeof(size));
+
+	auto it = dedup_map.find(key);
+
+	if ( it == dedup_map.end() )
+		{
+		++dedup_stats.misses;
+		dedup_lru.push_front({key, f->GetID(), 0.0});
+		dedup_map[key] = dedup_lru.begin();
+		f->dedup_key = std::move(key);
+
+		if ( dedup_map.size() > dedup_max_entries )
+			{
+			dedup_map.erase(dedup_lru.back().key);
+			dedup_lru.pop_back();
+			++dedup_stats.evictions;
+			}
+
+		return false;
+		}
+
+	auto entry = it->second;
+	dedup_lru.splice(dedup_lru.begin(), dedup_lru, entry);
+
+	++dedup_stats.hits;
+	dedup_stats.time_saved += entry->analysis_time;
+	f->duplicate = true;
+
+	DBG_LOG(DBG_FILE_ANALYSIS, "[%s] Duplicate of %s", f->GetID().c_str(),
+	        entry->file_id.c_str());
+
+	file_analysis::Analyzer* a = nullptr;
+	IterCookie* c = f->analyzers.InitForIteration();
+
+	while ( (a = f->analyzers.NextEntry(c)) )
+		{
+		if ( IsDedupSkipped(a->Tag()) )
+			{
+			a->SetSkip(true);
+			f->analyzers.QueueRemove(a->Tag(), a->Args());
+			}
+		}
+
+	if ( f->FileEventAvailable(file_duplicate) )
+		f->FileEvent(file_duplicate, {
+			IntrusivePtr{NewRef{}, f->val},
+			make_intrusive<StringVal>(entry->file_id)
+		});
+
+	return true;
+	}
+
+void Manager::FinishDuplicateCheck(File* f)
+	{
+	if ( f->dedup_key.empty() )
+		return;
+
+	auto it = dedup_map.find(f->dedup_key);
+
+	if ( it != dedup_map.end() && it->second->file_id == f->GetID() )
+		it->second->analysis_time = f->dedup_analysis_time;
+	}
+
 bool Manager::IsIgnored(const string& file_id)
 	{
 	return ignored.find(file_id) != ignored.end();
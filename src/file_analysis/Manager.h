@@ -5,6 +5,8 @@
 #include <string>
 #include <set>
 #include <map>
+#include <list>
+#include <unordered_map>
 
 #include "Component.h"
 #include "Net.h"
@@ -325,6 +327,38 @@ public:
 	 */
 	std::string DetectMIME(const u_char* data, uint64_t len) const;
 
+	/**
+	 * Looks up a file in the cache of recently seen files, keyed by a
+	 * fingerprint of its BOF buffer plus its total size (see
+	 * \c Files::dedup_cache_size).  If the file repeats a cached one,
+	 * the analyzers in \c Files::dedup_skip_analyzers are detached from it
+	 * and the \c file_duplicate event is raised.  Otherwise it's added to
+	 * the cache.
+	 * @param f the file, whose BOF buffer must be complete.
+	 * @return true if the file repeats a cached one.
+	 */
+	bool CheckDuplicate(File* f);
+
+	/**
+	 * @return whether analyzers of type \a tag are skipped for files that
+	 * repeat a cached one.
+	 */
+	bool IsDedupSkipped(const Tag& tag) const
+		{ return dedup_skip.find(tag) != dedup_skip.end(); }
+
+	/**
+	 * Statistics about the duplicate file cache.
+	 */
+	struct DedupStats {
+		uint64_t hits;	//! Number of files found to repeat a cached one.
+		uint64_t misses;	//! Number of files added to the cache.
+		uint64_t evictions;	//! Number of entries evicted from the cache.
+		double time_saved;	//! Analysis time the skipped analyzers took for the cached files.
+	};
+
+	const DedupStats& GetDedupStats() const
+		{ return dedup_stats; }
+
 	uint64_t CurrentFiles()
 		{ return id_map.size(); }
 
@@ -405,6 +439,20 @@ private:
 
 	TagSet* LookupMIMEType(const std::string& mtype, bool add_if_not_found);
 
+	/**
+	 * Stores the time the skippable analyzers spent on a file into its
+	 * duplicate cache entry.
+	 */
+	void FinishDuplicateCheck(File* f);
+
+	struct DedupEntry {
+		std::string key;	/**< Fingerprint of BOF buffer and size. */
+		std::string file_id;	/**< The first file seen with this key. */
+		double analysis_time;	/**< Time spent in skippable analyzers for it. */
+	};
+
+	typedef std::list<DedupEntry> DedupList;
+
 	std::map<std::string, File*> id_map;  /**< Map file ID to file_analysis::File records. */
 	std::set<std::string> ignored; /**< Ignored files.  Will be finally removed on EOF. */
 	std::string current_file_id;	/**< Hash of what get_file_handle event sets. */
@@ -416,6 +464,12 @@ private:
 
 	size_t cumulative_files;
 	size_t max_files;
+
+	size_t dedup_max_entries;	/**< Size bound of the duplicate cache, zero disables it. */
+	TagSet dedup_skip;	/**< Analyzers skipped for duplicate files. */
+	DedupList dedup_lru;	/**< Cache entries, most recently used first. */
+	std::unordered_map<std::string, DedupList::iterator> dedup_map;
+	DedupStats dedup_stats;
 };
 
 /**
@@ -1,19 +1,24 @@
 // See the file "COPYING" in the main distribution directory for copyright.
 
 #include <string>
+#include <algorithm>
 #include <fcntl.h>
 
 #include "Extract.h"
+#include "ExtractWriter.h"
 #include "util.h"
 #include "Event.h"
 #include "file_analysis/Manager.h"
 
+#include "consts.bif.h"
+
 using namespace file_analysis;
 
 Extract::Extract(RecordVal* args, File* file, const std::string& arg_filename,
                  uint64_t arg_limit)
     : file_analysis::Analyzer(file_mgr->GetComponentTag("EXTRACT"), args, file),
-      filename(arg_filename), limit(arg_limit), depth(0)
+      filename(arg_filename), limit(arg_limit), depth(0),
+      async(BifConst::FileExtract::async_writes)
 	{
 	fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0666);
 
@@ -28,7 +33,12 @@ Extract::Extract(RecordVal* args, File* file, const std::string& arg_filename,
 
 Extract::~Extract()
 	{
-	if ( fd )
+	if ( ! fd )
+		return;
+
+	if ( async )
+		ExtractWriter::Instance()->Close(fd);
+	else
 		safe_close(fd);
 	}
 
@@ -104,7 +114,11 @@ bool Extract::DeliverStream(const u_char* data, uint64_t len)
 
 	if ( towrite > 0 )
 		{
-		safe_write(fd, reinterpret_cast<const char*>(data), towrite);
+		if ( async )
+			ExtractWriter::Instance()->Write(fd, data, towrite);
+		else
+			safe_write(fd, reinterpret_cast<const char*>(data), towrite);
+
 		depth += towrite;
 		}
 
@@ -113,11 +127,25 @@ bool Extract::DeliverStream(const u_char* data, uint64_t len)
 
 bool Extract::Undelivered(uint64_t offset, uint64_t len)
 	{
-	if ( depth == offset )
+	if ( depth == offset && async )
 		{
-		char* tmp = new char[len]();
-		safe_write(fd, tmp, len);
-		delete [] tmp;
+		ExtractWriter::Instance()->WriteZeros(fd, len);
+		depth += len;
+		}
+	else if ( depth == offset )
+		{
+		// Fill the gap from a shared block of zeros instead of
+		// allocating a buffer the size of the gap.
+		static const char zeros[16384] = { 0 };
+		uint64_t remaining = len;
+
+		while ( remaining > 0 )
+			{
+			uint64_t n = std::min(remaining, uint64_t(sizeof(zeros)));
+			safe_write(fd, zeros, n);
+			remaining -= n;
+			}
+
 		depth += len;
 		}
 
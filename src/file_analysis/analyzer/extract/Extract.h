@@ -74,6 +74,7 @@ private:
 	int fd;
 	uint64_t limit;
 	uint64_t depth;
+	bool async;	// Whether writes go through the ExtractWriter thread.
 };
 
 } // namespace file_analysis
@@ -0,0 +1,178 @@
+// See the file "COPYING" in the main distribution directory for copyright.
+
+#include "ExtractWriter.h"
+
+#include <algorithm>
+
+#include "util.h"
+
+#include "consts.bif.h"
+
+using namespace file_analysis;
+
+class ExtractWriter::Thread : public threading::BasicThread {
+public:
+	explicit Thread(ExtractWriter* arg_writer) : writer(arg_writer)
+		{ SetName("file-extract"); }
+
+protected:
+	void Run() override
+		{
+		SetOSName(Name());
+		writer->Loop();
+		}
+
+	void OnSignalStop() override	{ writer->Stop(); }
+	void OnWaitForStop() override	{ writer->WaitForExit(); }
+	void OnKill() override	{ writer->Stop(); }
+
+private:
+	ExtractWriter* writer;
+};
+
+ExtractWriter* ExtractWriter::Instance()
+	{
+	static ExtractWriter* writer = nullptr;
+
+	if ( ! writer )
+		writer = new ExtractWriter();
+
+	return writer;
+	}
+
+ExtractWriter::ExtractWriter()
+	: max_buffer(BifConst::FileExtract::async_buffer_size),
+	  stopping(false), exited(false)
+	{
+	stats = {};
+	thread = new Thread(this);
+	thread->Start();
+	}
+
+bool ExtractWriter::Write(int fd, const u_char* data, uint64_t len)
+	{
+	if ( len == 0 )
+		return true;
+
+	std::unique_lock<std::mutex> lock(mutex);
+
+	if ( max_buffer && stats.pending + len > max_buffer )
+		{
+		stats.dropped += len;
+		lock.unlock();
+		WriteZeros(fd, len);
+		return false;
+		}
+
+	stats.pending += len;
+	stats.max_pending = std::max(stats.max_pending, stats.pending);
+	lock.unlock();
+
+	Queue({Op::WRITE, fd, len, std::vector<u_char>(data, data + len)});
+	return true;
+	}
+
+void ExtractWriter::WriteZeros(int fd, uint64_t len)
+	{
+	if ( len > 0 )
+		Queue({Op::ZEROS, fd, len, {}});
+	}
+
+void ExtractWriter::Close(int fd)
+	{
+	Queue({Op::CLOSE, fd, 0, {}});
+	}
+
+void ExtractWriter::GetStats(Stats* arg_stats)
+	{
+	std::unique_lock<std::mutex> lock(mutex);
+	*arg_stats = stats;
+	}
+
+void ExtractWriter::Queue(Op op)
+	{
+	std::unique_lock<std::mutex> lock(mutex);
+
+	if ( exited )
+		{
+		// Thread is gone already, do the work here.
+		lock.unlock();
+		uint64_t written = Perform(op);
+		lock.lock();
+		stats.written += written;
+		stats.pending -= written;
+		return;
+		}
+
+	ops.push_back(std::move(op));
+	cond.notify_one();
+	}
+
+uint64_t ExtractWriter::Perform(const Op& op)
+	{
+	static const char zeros[16384] = { 0 };
+
+	switch ( op.type ) {
+	case Op::WRITE:
+		safe_write(op.fd, reinterpret_cast<const char*>(op.data.data()), op.len);
+		return op.len;
+
+	case Op::ZEROS:
+		for ( uint64_t n = op.len; n > 0; )
+			{
+			uint64_t m = std::min(n, uint64_t(sizeof(zeros)));
+			safe_write(op.fd, zeros, m);
+			n -= m;
+			}
+		break;
+
+	case Op::CLOSE:
+		safe_close(op.fd);
+		break;
+	}
+
+	return 0;
+	}
+
+void ExtractWriter::Loop()
+	{
+	std::unique_lock<std::mutex> lock(mutex);
+
+	while ( true )
+		{
+		cond.wait(lock, [this] { return stopping || ! ops.empty(); });
+
+		if ( ops.empty() )
+			break;
+
+		std::deque<Op> todo;
+		todo.swap(ops);
+		lock.unlock();
+
+		uint64_t written = 0;
+
+		for ( const auto& op : todo )
+			written += Perform(op);
+
+		lock.lock();
+		stats.written += written;
+		stats.pending -= written;
+		}
+
+	exited = true;
+	cond.notify_all();
+	}
+
+void ExtractWriter::Stop()
+	{
+	std::unique_lock<std::mutex> lock(mutex);
+	stopping = true;
+	cond.notify_all();
+	}
+
+void ExtractWriter::WaitForExit()
+	{
+	// Let the thread drain what's still queued.
+	std::unique_lock<std::mutex> lock(mutex);
+	cond.wait(lock, [this] { return exited; });
+	}
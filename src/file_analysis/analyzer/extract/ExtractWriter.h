@@ -0,0 +1,95 @@
+// See the file "COPYING" in the main distribution directory for copyright.
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include "threading/BasicThread.h"
+
+namespace file_analysis {
+
+/**
+ * A dedicated I/O thread performing the disk writes of the file extraction
+ * analyzer (see \c FileExtract::async_writes), so that a slow disk doesn't
+ * stall packet processing.  Writes are buffered in memory up to
+ * \c FileExtract::async_buffer_size bytes; data arriving while the buffer
+ * is full is dropped and replaced by zeros in the extracted file, the same
+ * way gaps in the file's content are.
+ */
+class ExtractWriter {
+public:
+	/**
+	 * Statistics about the writer's work.
+	 */
+	struct Stats {
+		uint64_t written;	//! Number of bytes written to disk.
+		uint64_t pending;	//! Number of bytes currently buffered.
+		uint64_t max_pending;	//! High-water mark of buffered bytes.
+		uint64_t dropped;	//! Number of bytes dropped because the buffer was full.
+	};
+
+	/**
+	 * Returns the global writer, starting its thread on first use.  Only
+	 * the main thread may call this.
+	 */
+	static ExtractWriter* Instance();
+
+	/**
+	 * Queues data to be appended to a file.  The data is copied.
+	 * @param fd the file descriptor to write to.
+	 * @param data the data to write.
+	 * @param len the number of bytes to write.
+	 * @return false if the data didn't fit into the buffer and has been
+	 * replaced by zeros, else true.
+	 */
+	bool Write(int fd, const u_char* data, uint64_t len);
+
+	/**
+	 * Queues \a len zero bytes to be appended to a file.
+	 */
+	void WriteZeros(int fd, uint64_t len);
+
+	/**
+	 * Queues closing a file once all its pending writes are done.  The
+	 * descriptor must not be used afterwards.
+	 */
+	void Close(int fd);
+
+	/**
+	 * Fills in the current statistics.
+	 */
+	void GetStats(Stats* stats);
+
+private:
+	class Thread;
+
+	ExtractWriter();
+
+	void Loop();
+	void Stop();
+	void WaitForExit();
+
+	struct Op {
+		enum Type { WRITE, ZEROS, CLOSE } type;
+		int fd;
+		uint64_t len;
+		std::vector<u_char> data;
+	};
+
+	void Queue(Op op);
+	static uint64_t Perform(const Op& op);
+
+	Thread* thread;	// Owned by the threading::Manager.
+	std::mutex mutex;
+	std::condition_variable cond;
+	std::deque<Op> ops;	// Guarded by mutex.
+	uint64_t max_buffer;
+	bool stopping;
+	bool exited;
+	Stats stats;
+};
+
+} // namespace file_analysis
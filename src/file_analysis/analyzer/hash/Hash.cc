@@ -7,16 +7,24 @@
 #include "Event.h"
 #include "file_analysis/Manager.h"
 
+#include "consts.bif.h"
+
 using namespace file_analysis;
 
-Hash::Hash(RecordVal* args, File* file, HashVal* hv, const char* arg_kind)
+Hash::Hash(RecordVal* args, File* file, HashVal* hv, HashAlgorithm alg, const char* arg_kind)
 	: file_analysis::Analyzer(file_mgr->GetComponentTag(to_upper(arg_kind).c_str()), args, file), hash(hv), fed(false), kind(arg_kind)
 	{
 	hash->Init();
+
+	if ( BifConst::FileHash::async_hashing )
+		job = HashPool::Instance()->NewJob(alg);
 	}
 
 Hash::~Hash()
 	{
+	if ( job )
+		HashPool::Instance()->Cancel(job);
+
 	Unref(hash);
 	}
 
@@ -28,7 +36,11 @@ bool Hash::DeliverStream(const u_char* data, uint64_t len)
 	if ( ! fed )
 		fed = len > 0;
 
-	hash->Feed(data, len);
+	if ( job )
+		HashPool::Instance()->Feed(job, data, len);
+	else
+		hash->Feed(data, len);
+
 	return true;
 	}
 
@@ -51,9 +63,25 @@ void Hash::Finalize()
 	if ( ! file_hash )
 		return;
 
+	IntrusivePtr<StringVal> digest;
+
+	if ( job )
+		{
+		auto hex = HashPool::Instance()->Finish(job);
+		job = nullptr;
+		fed = false;
+
+		if ( hex.empty() )
+			return;
+
+		digest = make_intrusive<StringVal>(hex);
+		}
+	else
+		digest = hash->Get();
+
 	mgr.Enqueue(file_hash,
 		IntrusivePtr{NewRef{}, GetFile()->GetVal()},
 		make_intrusive<StringVal>(kind),
-		hash->Get()
+		std::move(digest)
 	);
 	}
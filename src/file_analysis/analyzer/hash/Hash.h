@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 
 #include "Val.h"
@@ -9,6 +10,8 @@
 #include "File.h"
 #include "Analyzer.h"
 
+#include "HashPool.h"
+
 #include "events.bif.h"
 
 namespace file_analysis {
@@ -54,9 +57,13 @@ protected:
 	 * @param args the \c AnalyzerArgs value which represents the analyzer.
 	 * @param file the file to which the analyzer will be attached.
 	 * @param hv specific hash calculator object.
+	 * @param alg the algorithm \a hv implements, used when the digest is
+	 *        computed by the HashPool instead (see
+	 *        \c FileHash::async_hashing).
 	 * @param kind human readable name of the hash algorithm to use.
 	 */
-	Hash(RecordVal* args, File* file, HashVal* hv, const char* kind);
+	Hash(RecordVal* args, File* file, HashVal* hv, HashAlgorithm alg,
+	     const char* kind);
 
 	/**
 	 * If some file contents have been seen, finalizes the hash of them and
@@ -66,6 +73,7 @@ protected:
 
 private:
 	HashVal* hash;
+	std::shared_ptr<HashJob> job;
 	bool fed;
 	const char* kind;
 };
@@ -94,7 +102,7 @@ protected:
 	 * @param file the file to which the analyzer will be attached.
 	 */
 	MD5(RecordVal* args, File* file)
-		: Hash(args, file, new MD5Val(), "md5")
+		: Hash(args, file, new MD5Val(), Hash_MD5, "md5")
 		{}
 };
 
@@ -122,7 +130,7 @@ protected:
 	 * @param file the file to which the analyzer will be attached.
 	 */
 	SHA1(RecordVal* args, File* file)
-		: Hash(args, file, new SHA1Val(), "sha1")
+		: Hash(args, file, new SHA1Val(), Hash_SHA1, "sha1")
 		{}
 };
 
@@ -150,7 +158,7 @@ protected:
 	 * @param file the file to which the analyzer will be attached.
 	 */
 	SHA256(RecordVal* args, File* file)
-		: Hash(args, file, new SHA256Val(), "sha256")
+		: Hash(args, file, new SHA256Val(), Hash_SHA256, "sha256")
 		{}
 };
 
@@ -0,0 +1,233 @@
+// See the file "COPYING" in the main distribution directory for copyright.
+
+#include "HashPool.h"
+
+#include <algorithm>
+
+#include "util.h"
+
+#include "consts.bif.h"
+
+using namespace file_analysis;
+
+class HashPool::Worker : public threading::BasicThread {
+public:
+	Worker(HashPool* arg_pool, int idx) : exited(false), pool(arg_pool)
+		{ SetName(fmt("file-hash-%d", idx)); }
+
+	bool exited;	// Guarded by the pool's mutex.
+
+protected:
+	void Run() override
+		{
+		SetOSName(Name());
+		pool->WorkerLoop(this);
+		}
+
+	void OnSignalStop() override
+		{
+		pool->Stop();
+		}
+
+	void OnWaitForStop() override
+		{
+		std::unique_lock<std::mutex> lock(pool->mutex);
+		pool->done_cond.wait(lock, [this] { return exited; });
+		}
+
+	void OnKill() override
+		{
+		pool->Stop();
+		}
+
+private:
+	HashPool* pool;
+};
+
+HashJob::HashJob(HashAlgorithm alg)
+	: scheduled(false), finishing(false), done(false), failed(false),
+	  digest_len(0)
+	{
+	ctx = hash_init(alg);
+	}
+
+HashJob::~HashJob()
+	{
+	if ( ctx )
+		EVP_MD_CTX_free(ctx);
+	}
+
+HashPool* HashPool::Instance()
+	{
+	static HashPool* pool = nullptr;
+
+	if ( ! pool )
+		pool = new HashPool(std::max(1, int(BifConst::FileHash::async_threads)));
+
+	return pool;
+	}
+
+HashPool::HashPool(int num_threads)
+	: running(0), stopping(false),
+	  max_pending(BifConst::FileHash::async_max_pending_bytes)
+	{
+	stats = {};
+
+	for ( int i = 0; i < num_threads; ++i )
+		{
+		auto w = new Worker(this, i);
+		workers.push_back(w);
+		++running;
+		w->Start();
+		}
+	}
+
+void HashPool::Stop()
+	{
+	std::unique_lock<std::mutex> lock(mutex);
+	stopping = true;
+	work_cond.notify_all();
+	done_cond.notify_all();
+	}
+
+std::shared_ptr<HashJob> HashPool::NewJob(HashAlgorithm alg)
+	{
+	std::unique_lock<std::mutex> lock(mutex);
+	++stats.jobs;
+	return std::make_shared<HashJob>(alg);
+	}
+
+void HashPool::Feed(const std::shared_ptr<HashJob>& job, const u_char* data, uint64_t len)
+	{
+	if ( len == 0 )
+		return;
+
+	std::unique_lock<std::mutex> lock(mutex);
+
+	if ( max_pending && stats.pending_bytes + len > max_pending && running > 0 && ! stopping )
+		{
+		++stats.stalls;
+		done_cond.wait(lock, [this, len]
+			{ return stats.pending_bytes + len <= max_pending ||
+			         stats.pending_bytes == 0 || stopping; });
+		}
+
+	job->chunks.emplace_back(data, data + len);
+	++stats.chunks;
+	stats.bytes += len;
+	stats.pending_bytes += len;
+
+	if ( ! job->scheduled )
+		{
+		job->scheduled = true;
+		runnable.push_back(job);
+		work_cond.notify_one();
+		}
+	}
+
+std::string HashPool::Finish(const std::shared_ptr<HashJob>& job)
+	{
+	std::unique_lock<std::mutex> lock(mutex);
+	job->finishing = true;
+
+	if ( ! job->scheduled && ! job->done )
+		{
+		// Nothing left in the queue, the digest can be finalized right
+		// away.
+		job->scheduled = true;
+		Process(job, lock);
+		}
+
+	done_cond.wait(lock, [this, &job]
+		{ return job->done || (stopping && running == 0); });
+
+	if ( ! job->done )
+		{
+		// The workers went away while the job was still queued; finish
+		// it on the main thread instead.
+		Process(job, lock);
+		}
+
+	if ( job->failed )
+		return "";
+
+	return digest_print(job->digest, job->digest_len);
+	}
+
+void HashPool::Cancel(const std::shared_ptr<HashJob>& job)
+	{
+	std::unique_lock<std::mutex> lock(mutex);
+
+	for ( const auto& c : job->chunks )
+		stats.pending_bytes -= c.size();
+
+	job->chunks.clear();
+	job->finishing = false;
+	done_cond.notify_all();
+	}
+
+void HashPool::GetStats(Stats* arg_stats)
+	{
+	std::unique_lock<std::mutex> lock(mutex);
+	*arg_stats = stats;
+	}
+
+bool HashPool::Process(const std::shared_ptr<HashJob>& job, std::unique_lock<std::mutex>& lock)
+	{
+	while ( ! job->chunks.empty() )
+		{
+		std::deque<std::vector<u_char>> todo;
+		todo.swap(job->chunks);
+		lock.unlock();
+
+		uint64_t n = 0;
+
+		for ( const auto& c : todo )
+			{
+			if ( ! job->failed && ! EVP_DigestUpdate(job->ctx, c.data(), c.size()) )
+				job->failed = true;
+
+			n += c.size();
+			}
+
+		lock.lock();
+		stats.pending_bytes -= n;
+		done_cond.notify_all();
+		}
+
+	if ( job->finishing && ! job->done )
+		{
+		if ( ! job->failed &&
+		     ! EVP_DigestFinal(job->ctx, job->digest, &job->digest_len) )
+			job->failed = true;
+
+		EVP_MD_CTX_free(job->ctx);
+		job->ctx = nullptr;
+		job->done = true;
+		}
+
+	job->scheduled = false;
+	done_cond.notify_all();
+	return job->done;
+	}
+
+void HashPool::WorkerLoop(Worker* w)
+	{
+	std::unique_lock<std::mutex> lock(mutex);
+
+	while ( true )
+		{
+		work_cond.wait(lock, [this] { return stopping || ! runnable.empty(); });
+
+		if ( runnable.empty() )
+			break;
+
+		auto job = std::move(runnable.front());
+		runnable.pop_front();
+		Process(job, lock);
+		}
+
+	--running;
+	w->exited = true;
+	done_cond.notify_all();
+	}
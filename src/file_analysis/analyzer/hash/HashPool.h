@@ -0,0 +1,127 @@
+// See the file "COPYING" in the main distribution directory for copyright.
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "digest.h"
+#include "threading/BasicThread.h"
+
+namespace file_analysis {
+
+class HashPool;
+
+/**
+ * A single digest computation whose input is queued from the main thread
+ * and consumed by one of the HashPool's worker threads.  At most one
+ * worker processes a given job at any time, so chunks are always digested
+ * in the order they were queued.
+ */
+class HashJob {
+public:
+	/**
+	 * Constructor.
+	 * @param alg the digest algorithm to compute.
+	 */
+	explicit HashJob(HashAlgorithm alg);
+
+	/**
+	 * Destructor.  Releases the digest context if it wasn't finalized.
+	 */
+	~HashJob();
+
+private:
+	friend class HashPool;
+
+	EVP_MD_CTX* ctx;
+	std::deque<std::vector<u_char>> chunks; // Guarded by the pool's mutex.
+	bool scheduled;	// True while queued for or owned by a worker.
+	bool finishing;	// True once no more chunks will be added.
+	bool done;	// True once the digest has been computed.
+	bool failed;	// True if the digest context reported an error.
+	u_char digest[EVP_MAX_MD_SIZE];
+	unsigned int digest_len;
+};
+
+/**
+ * A fixed set of worker threads that compute file digests off the main
+ * thread.  The file hash analyzers feed chunks into per-analyzer HashJob
+ * queues and only block at end-of-file while the remaining queued data of
+ * that single file gets digested, so the "file_hash" event is still raised
+ * in the same order relative to the other file events as in synchronous
+ * mode.
+ */
+class HashPool {
+public:
+	/**
+	 * Statistics about the pool's work.
+	 */
+	struct Stats {
+		uint64_t jobs;	//! Number of digest computations started.
+		uint64_t chunks;	//! Number of data chunks handed to workers.
+		uint64_t bytes;	//! Number of bytes handed to workers.
+		uint64_t pending_bytes;	//! Number of bytes currently queued.
+		uint64_t stalls;	//! Number of times the main thread waited for queue space.
+	};
+
+	/**
+	 * Returns the global pool, starting its worker threads on first use.
+	 * Only the main thread may call this.
+	 */
+	static HashPool* Instance();
+
+	/**
+	 * Creates a new job for the given algorithm.
+	 */
+	std::shared_ptr<HashJob> NewJob(HashAlgorithm alg);
+
+	/**
+	 * Queues a chunk of data for a job.  The data is copied.  If the
+	 * amount of queued data exceeds \c FileHash::async_max_pending_bytes,
+	 * this blocks until the workers have caught up.
+	 */
+	void Feed(const std::shared_ptr<HashJob>& job, const u_char* data, uint64_t len);
+
+	/**
+	 * Waits until all data queued for a job has been digested and returns
+	 * the result as a hex string.
+	 * @return the digest, or an empty string if it couldn't be computed.
+	 */
+	std::string Finish(const std::shared_ptr<HashJob>& job);
+
+	/**
+	 * Discards any data still queued for a job.
+	 */
+	void Cancel(const std::shared_ptr<HashJob>& job);
+
+	/**
+	 * Fills in the current statistics.
+	 */
+	void GetStats(Stats* stats);
+
+private:
+	class Worker;
+
+	explicit HashPool(int num_threads);
+
+	void Stop();
+	void WorkerLoop(Worker* w);
+	bool Process(const std::shared_ptr<HashJob>& job, std::unique_lock<std::mutex>& lock);
+
+	std::mutex mutex;
+	std::condition_variable work_cond;
+	std::condition_variable done_cond;
+	std::deque<std::shared_ptr<HashJob>> runnable;
+	std::vector<Worker*> workers;	// Owned by the threading::Manager.
+	int running;	// Number of workers still in their main loop.
+	bool stopping;
+	uint64_t max_pending;
+	Stats stats;
+};
+
+} // namespace file_analysis
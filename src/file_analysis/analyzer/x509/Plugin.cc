@@ -26,6 +26,7 @@ public:
 		{
 		plugin::Plugin::Done();
 		::file_analysis::X509::FreeRootStore();
+		::file_analysis::X509::FlushParseCache();
 		}
 } plugin;
 
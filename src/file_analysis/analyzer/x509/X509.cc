@@ -7,6 +7,7 @@
 
 #include "events.bif.h"
 #include "types.bif.h"
+#include "consts.bif.h"
 
 #include "file_analysis/File.h"
 #include "file_analysis/Manager.h"
@@ -42,13 +43,19 @@ bool file_analysis::X509::Undelivered(uint64_t offset, uint64_t len)
 bool file_analysis::X509::EndOfFile()
 	{
 	const unsigned char* cert_char = reinterpret_cast<const unsigned char*>(cert_data.data());
-	if ( certificate_cache )
+	bool use_parse_cache = BifConst::X509::parse_cache_size > 0;
+	unsigned char buf[SHA256_DIGEST_LENGTH];
+
+	if ( certificate_cache || use_parse_cache )
 		{
-		// first step - let's see if the certificate has been cached.
-		unsigned char buf[SHA256_DIGEST_LENGTH];
 		auto ctx = hash_init(Hash_SHA256);
 		hash_update(ctx, cert_char, cert_data.size());
 		hash_final(ctx, buf);
+		}
+
+	if ( certificate_cache )
+		{
+		// first step - let's see if the certificate has been cached.
 		std::string cert_sha256 = sha256_digest_print(buf);
 		auto index = make_intrusive<StringVal>(cert_sha256);
 		auto entry = certificate_cache->Lookup(index.get(), false);
@@ -67,6 +74,32 @@ bool file_analysis::X509::EndOfFile()
 			}
 		}
 
+	if ( ! use_parse_cache )
+		{
+		ParseAndRaise(nullptr);
+		return false;
+		}
+
+	std::string der_hash(reinterpret_cast<const char*>(buf), sizeof(buf));
+
+	if ( ReplayFromParseCache(der_hash) )
+		return false;
+
+	// Certificates that trigger weirds aren't cached, so that the weirds
+	// keep getting reported for every copy.
+	EventList events;
+	uint64_t weirds = reporter->GetWeirdCount();
+
+	if ( ParseAndRaise(&events) && reporter->GetWeirdCount() == weirds )
+		InsertIntoParseCache(der_hash, std::move(events));
+
+	return false;
+	}
+
+bool file_analysis::X509::ParseAndRaise(EventList* events)
+	{
+	const unsigned char* cert_char = reinterpret_cast<const unsigned char*>(cert_data.data());
+
 	// ok, now we can try to parse the certificate with openssl. Should
 	// be rather straightforward...
 	::X509* ssl_cert = d2i_X509(NULL, &cert_char, cert_data.size());
@@ -81,12 +114,10 @@ bool file_analysis::X509::EndOfFile()
 	// parse basic information into record.
 	auto cert_record = ParseCertificate(cert_val, GetFile());
 
+	recorded_events = events;
+
 	// and send the record on to scriptland
-	if ( x509_certificate )
-		mgr.Enqueue(x509_certificate,
-		            IntrusivePtr{NewRef{}, GetFile()->GetVal()},
-		            IntrusivePtr{NewRef{}, cert_val},
-		            cert_record);
+	EnqueueFileEvent(x509_certificate, {IntrusivePtr{NewRef{}, cert_val}, cert_record});
 
 	// after parsing the certificate - parse the extensions...
 
@@ -100,6 +131,8 @@ bool file_analysis::X509::EndOfFile()
 		ParseExtension(ex, x509_extension, false);
 		}
 
+	recorded_events = nullptr;
+
 	// X509_free(ssl_cert); We do _not_ free the certificate here. It is refcounted
 	// inside the X509Val that is sent on in the cert record to scriptland.
 	//
@@ -107,7 +140,52 @@ bool file_analysis::X509::EndOfFile()
 
 	Unref(cert_val); // Same for cert_val
 
-	return false;
+	return true;
+	}
+
+bool file_analysis::X509::ReplayFromParseCache(const std::string& der_hash)
+	{
+	auto it = parse_cache_map.find(der_hash);
+
+	if ( it == parse_cache_map.end() )
+		{
+		++parse_cache_stats.misses;
+		return false;
+		}
+
+	++parse_cache_stats.hits;
+	parse_cache_lru.splice(parse_cache_lru.begin(), parse_cache_lru, it->second);
+
+	for ( const auto& e : it->second->events )
+		EnqueueFileEvent(e.first, e.second);
+
+	return true;
+	}
+
+void file_analysis::X509::InsertIntoParseCache(const std::string& der_hash, EventList events)
+	{
+	parse_cache_lru.push_front({der_hash, std::move(events)});
+	parse_cache_map[der_hash] = parse_cache_lru.begin();
+
+	while ( parse_cache_map.size() > BifConst::X509::parse_cache_size )
+		{
+		parse_cache_map.erase(parse_cache_lru.back().der_hash);
+		parse_cache_lru.pop_back();
+		++parse_cache_stats.evictions;
+		}
+	}
+
+file_analysis::X509::ParseCacheStats file_analysis::X509::GetParseCacheStats()
+	{
+	ParseCacheStats stats = parse_cache_stats;
+	stats.entries = parse_cache_map.size();
+	return stats;
+	}
+
+void file_analysis::X509::FlushParseCache()
+	{
+	parse_cache_map.clear();
+	parse_cache_lru.clear();
 	}
 
 IntrusivePtr<RecordVal> file_analysis::X509::ParseCertificate(X509Val* cert_val, File* f)
@@ -294,10 +372,7 @@ void file_analysis::X509::ParseBasicConstraints(X509_EXTENSION* ex)
 			if ( constr->pathlen )
 				pBasicConstraint->Assign(1, val_mgr->Count((int32_t) ASN1_INTEGER_get(constr->pathlen)));
 
-			mgr.Enqueue(x509_ext_basic_constraints,
-				IntrusivePtr{NewRef{}, GetFile()->GetVal()},
-				std::move(pBasicConstraint)
-			);
+			EnqueueFileEvent(x509_ext_basic_constraints, {std::move(pBasicConstraint)});
 			}
 
 		BASIC_CONSTRAINTS_free(constr);
@@ -435,9 +510,7 @@ void file_analysis::X509::ParseSAN(X509_EXTENSION* ext)
 
 		sanExt->Assign(4, val_mgr->Bool(otherfields));
 
-		mgr.Enqueue(x509_ext_subject_alternative_name,
-		            IntrusivePtr{NewRef{}, GetFile()->GetVal()},
-		            std::move(sanExt));
+		EnqueueFileEvent(x509_ext_subject_alternative_name, {std::move(sanExt)});
 	GENERAL_NAMES_free(altname);
 	}
 
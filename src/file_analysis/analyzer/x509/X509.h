@@ -3,7 +3,9 @@
 #pragma once
 
 #include <string>
+#include <list>
 #include <map>
+#include <unordered_map>
 
 #include "OpaqueVal.h"
 #include "X509Common.h"
@@ -125,6 +127,26 @@ public:
 	static void SetCertificateCacheHitCallback(IntrusivePtr<Func> func)
 		{ cache_hit_callback = std::move(func); }
 
+	/**
+	 * Statistics about the parse cache.
+	 */
+	struct ParseCacheStats {
+		uint64_t hits;	//! Certificates whose events were replayed from the cache.
+		uint64_t misses;	//! Certificates that had to be parsed.
+		uint64_t evictions;	//! Entries removed to make room for new ones.
+		uint64_t entries;	//! Number of certificates currently cached.
+	};
+
+	/**
+	 * Returns statistics about the parse cache.
+	 */
+	static ParseCacheStats GetParseCacheStats();
+
+	/**
+	 * Removes all entries from the parse cache.
+	 */
+	static void FlushParseCache();
+
 protected:
 	X509(RecordVal* args, File* file);
 
@@ -133,6 +155,19 @@ private:
 	void ParseSAN(X509_EXTENSION* ex);
 	void ParseExtensionsSpecific(X509_EXTENSION* ex, bool, ASN1_OBJECT*, const char*) override;
 
+	// Parses the certificate in cert_data and raises the corresponding
+	// events, recording them into *events if non-null.  Returns false if
+	// the certificate couldn't be parsed.
+	bool ParseAndRaise(EventList* events);
+
+	// Raises the events of a certificate found in the parse cache.
+	// Returns false if the certificate isn't cached.
+	bool ReplayFromParseCache(const std::string& der_hash);
+
+	// Adds a parsed certificate's events to the parse cache, evicting the
+	// least recently used entries if it's full.
+	static void InsertIntoParseCache(const std::string& der_hash, EventList events);
+
 	std::string cert_data;
 
 	// Helpers for ParseCertificate.
@@ -142,6 +177,22 @@ private:
 	inline static std::map<Val*, X509_STORE*> x509_stores = std::map<Val*, X509_STORE*>();
 	inline static IntrusivePtr<TableVal> certificate_cache = nullptr;
 	inline static IntrusivePtr<Func> cache_hit_callback = nullptr;
+
+	/**
+	 * The parse cache maps the SHA256 of a certificate's DER encoding to
+	 * all the events that parsing it raised, minus the leading file
+	 * argument.  It's ordered by recency of use, most recent first.
+	 */
+	struct ParseCacheEntry {
+		std::string der_hash;
+		EventList events;
+	};
+
+	typedef std::list<ParseCacheEntry> ParseCacheList;
+
+	inline static ParseCacheList parse_cache_lru;
+	inline static std::unordered_map<std::string, ParseCacheList::iterator> parse_cache_map;
+	inline static ParseCacheStats parse_cache_stats = {};
 };
 
 /**
@@ -3,6 +3,7 @@
 #include "X509Common.h"
 #include "x509-extension_pac.h"
 #include "Reporter.h"
+#include "Event.h"
 
 #include "events.bif.h"
 #include "ocsp_events.bif.h"
@@ -287,17 +288,26 @@ void file_analysis::X509Common::ParseExtension(X509_EXTENSION* ex, const EventHa
 	// but I am not sure if there is a better way to do it...
 
 	if ( h == ocsp_extension )
-		mgr.Enqueue(h, IntrusivePtr{NewRef{}, GetFile()->GetVal()},
-					std::move(pX509Ext),
-					val_mgr->Bool(global));
+		EnqueueFileEvent(h, {std::move(pX509Ext), val_mgr->Bool(global)});
 	else
-		mgr.Enqueue(h, IntrusivePtr{NewRef{}, GetFile()->GetVal()},
-		            std::move(pX509Ext));
+		EnqueueFileEvent(h, {std::move(pX509Ext)});
 
 	// let individual analyzers parse more.
 	ParseExtensionsSpecific(ex, global, ext_asn, oid);
 	}
 
+void file_analysis::X509Common::EnqueueFileEvent(const EventHandlerPtr& h, zeek::Args args)
+	{
+	if ( ! h )
+		return;
+
+	if ( recorded_events )
+		recorded_events->emplace_back(h, args);
+
+	args.insert(args.begin(), IntrusivePtr{NewRef{}, GetFile()->GetVal()});
+	mgr.Enqueue(h, std::move(args));
+	}
+
 IntrusivePtr<StringVal> file_analysis::X509Common::GetExtensionFromBIO(BIO* bio, File* f)
 	{
 	BIO_flush(bio);
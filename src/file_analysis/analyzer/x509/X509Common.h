@@ -6,11 +6,15 @@
 #pragma once
 
 #include "file_analysis/Analyzer.h"
+#include "EventHandler.h"
+#include "ZeekArgs.h"
+
+#include <utility>
+#include <vector>
 
 #include <openssl/x509.h>
 #include <openssl/asn1.h>
 
-class EventHandlerPtr;
 class Reporter;
 class StringVal;
 template <class T> class IntrusivePtr;
@@ -39,12 +43,28 @@ public:
 
 	static double GetTimeFromAsn1(const ASN1_TIME* atime, File* f, Reporter* reporter);
 
+	/**
+	 * Queues an event about the analyzed file. The file's record value
+	 * gets passed as the first argument, followed by \a args.
+	 *
+	 * @param h the event to raise.
+	 *
+	 * @param args the event arguments following the file.
+	 */
+	void EnqueueFileEvent(const EventHandlerPtr& h, zeek::Args args);
+
+	typedef std::vector<std::pair<EventHandlerPtr, zeek::Args>> EventList;
+
 protected:
 	X509Common(const file_analysis::Tag& arg_tag, RecordVal* arg_args, File* arg_file);
 
 	void ParseExtension(X509_EXTENSION* ex, const EventHandlerPtr& h, bool global);
 	void ParseSignedCertificateTimestamps(X509_EXTENSION* ext);
 	virtual void ParseExtensionsSpecific(X509_EXTENSION* ex, bool, ASN1_OBJECT*, const char*) = 0;
+
+	// If set, EnqueueFileEvent() also appends each event here (without
+	// the file argument) so that it can be replayed later.
+	EventList* recorded_events = nullptr;
 };
 
 }
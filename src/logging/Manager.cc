@@ -1052,6 +1052,43 @@ threading::Value* Manager::ValToLogVal(Val* val, BroType* ty)
 	return lval;
 	}
 
+threading::Value* Manager::RecordFieldToLogVal(RecordVal* rec, int field)
+	{
+	BroType* ty = rec->Type()->AsRecordType()->FieldType(field);
+	threading::Value* lval;
+
+	// Fields of scalar type may not have a Val yet, and there's no need
+	// to create one just for logging them.
+	switch ( ty->Tag() ) {
+	case TYPE_BOOL:
+	case TYPE_INT:
+		lval = new threading::Value(ty->Tag());
+		lval->val.int_val = rec->FieldInt(field);
+		return lval;
+
+	case TYPE_COUNT:
+	case TYPE_COUNTER:
+		lval = new threading::Value(ty->Tag());
+		lval->val.uint_val = rec->FieldUnsigned(field);
+		return lval;
+
+	case TYPE_DOUBLE:
+	case TYPE_TIME:
+	case TYPE_INTERVAL:
+		lval = new threading::Value(ty->Tag());
+		lval->val.double_val = rec->FieldDouble(field);
+		return lval;
+
+	case TYPE_ADDR:
+		lval = new threading::Value(ty->Tag());
+		rec->FieldAddr(field).ConvertToThreadingValue(&lval->val.addr_val);
+		return lval;
+
+	default:
+		return ValToLogVal(rec->Lookup(field));
+	}
+	}
+
 threading::Value** Manager::RecordToFilterVals(Stream* stream, Filter* filter,
                                                RecordVal* columns)
 	{
@@ -1090,18 +1127,23 @@ threading::Value** Manager::RecordToFilterVals(Stream* stream, Filter* filter,
 
 		for ( list<int>::iterator j = indices.begin(); j != indices.end(); ++j )
 			{
-			val = val->AsRecordVal()->Lookup(*j);
+			RecordVal* rec = val->AsRecordVal();
 
-			if ( ! val )
+			if ( ! rec->HasField(*j) )
 				{
 				// Value, or any of its parents, is not set.
 				vals[i] = new threading::Value(filter->fields[i]->type, false);
 				break;
 				}
-			}
 
-		if ( val )
-			vals[i] = ValToLogVal(val);
+			if ( std::next(j) == indices.end() )
+				{
+				vals[i] = RecordFieldToLogVal(rec, *j);
+				break;
+				}
+
+			val = rec->Lookup(*j);
+			}
 		}
 
 	return vals;
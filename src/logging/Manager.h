@@ -262,6 +262,7 @@ private:
 				    RecordVal* columns);
 
 	threading::Value* ValToLogVal(Val* val, BroType* ty = nullptr);
+	threading::Value* RecordFieldToLogVal(RecordVal* rec, int field);
 	Stream* FindStream(EnumVal* id);
 	void RemoveDisabledWriters(Stream* stream);
 	void InstallRotationTimer(WriterInfo* winfo);
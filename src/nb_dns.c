@@ -284,12 +284,16 @@ nb_dns_init2(char *errstr, struct sockaddr* sa)
 	if ( sa->sa_family == AF_INET )
 		{
 		memcpy(&nd->server, sa, sizeof(struct sockaddr_in));
-		((struct sockaddr_in*)&nd->server)->sin_port = htons(53);
+
+		if ( ((struct sockaddr_in*)&nd->server)->sin_port == 0 )
+			((struct sockaddr_in*)&nd->server)->sin_port = htons(53);
 		}
 	else
 		{
 		memcpy(&nd->server, sa, sizeof(struct sockaddr_in6));
-		((struct sockaddr_in6*)&nd->server)->sin6_port = htons(53);
+
+		if ( ((struct sockaddr_in6*)&nd->server)->sin6_port == 0 )
+			((struct sockaddr_in6*)&nd->server)->sin6_port = htons(53);
 		}
 
 	nd->s = socket(nd->server.ss_family, SOCK_DGRAM, 0);
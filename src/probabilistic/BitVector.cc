@@ -380,6 +380,44 @@ BitVector& BitVector::Set(size_type i, bool bit)
 	return *this;
 	}
 
+uint64_t BitVector::GetBits(size_type i, size_t n) const
+	{
+	assert(n > 0 && n <= bits_per_block && i + n <= num_bits);
+
+	size_type bi = block_index(i);
+	block_type off = bit_index(i);
+	block_type rval = bits[bi] >> off;
+
+	// The range may straddle two blocks.
+	if ( off + n > bits_per_block )
+		rval |= bits[bi + 1] << (bits_per_block - off);
+
+	if ( n < bits_per_block )
+		rval &= (block_type(1) << n) - 1;
+
+	return rval;
+	}
+
+BitVector& BitVector::SetBits(size_type i, size_t n, uint64_t value)
+	{
+	assert(n > 0 && n <= bits_per_block && i + n <= num_bits);
+
+	block_type mask = n < bits_per_block ? (block_type(1) << n) - 1 : ~block_type(0);
+	size_type bi = block_index(i);
+	block_type off = bit_index(i);
+
+	value &= mask;
+	bits[bi] = (bits[bi] & ~(mask << off)) | (value << off);
+
+	if ( off + n > bits_per_block )
+		{
+		block_type hi_mask = mask >> (bits_per_block - off);
+		bits[bi + 1] = (bits[bi + 1] & ~hi_mask) | (value >> (bits_per_block - off));
+		}
+
+	return *this;
+	}
+
 BitVector& BitVector::Set()
 	{
 	std::fill(bits.begin(), bits.end(), ~block_type(0));
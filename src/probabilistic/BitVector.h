@@ -230,6 +230,26 @@ public:
 	 */
 	const_reference operator[](size_type i) const;
 
+	/**
+	 * Retrieves a range of up to 64 adjacent bits at once.
+	 * @param i The position of the first bit.
+	 * @param n The number of bits.
+	 * @return The bits, with the one at position *i* as least significant.
+	 * @pre `0 < n <= 64 && i + n <= Size()`
+	 */
+	uint64_t GetBits(size_type i, size_t n) const;
+
+	/**
+	 * Assigns a range of up to 64 adjacent bits at once.
+	 * @param i The position of the first bit.
+	 * @param n The number of bits.
+	 * @param value The bits to assign, with the one for position *i* as
+	 * least significant.  Higher bits than *n* are ignored.
+	 * @return A reference to the bit vector instance.
+	 * @pre `0 < n <= 64 && i + n <= Size()`
+	 */
+	BitVector& SetBits(size_type i, size_t n, uint64_t value);
+
 	/**
 	 * Counts the number of 1-bits in the bit vector. Also known as *population
 	 * count* or *Hamming weight*.
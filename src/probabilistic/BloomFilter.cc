@@ -79,6 +79,32 @@ std::unique_ptr<BloomFilter> BloomFilter::Unserialize(const broker::data& data)
 	return bf;
 	}
 
+void BloomFilter::AddAll(const std::vector<HashKey*>& keys)
+	{
+	Hasher::digest_vector h(hasher->K());
+
+	for ( const auto& key : keys )
+		{
+		hasher->Hash(key, h.data());
+		AddDigests(h.data());
+		}
+	}
+
+std::vector<size_t> BloomFilter::CountAll(const std::vector<HashKey*>& keys) const
+	{
+	Hasher::digest_vector h(hasher->K());
+	std::vector<size_t> rval;
+	rval.reserve(keys.size());
+
+	for ( const auto& key : keys )
+		{
+		hasher->Hash(key, h.data());
+		rval.push_back(CountDigests(h.data()));
+		}
+
+	return rval;
+	}
+
 size_t BasicBloomFilter::M(double fp, size_t capacity)
 	{
 	double ln2 = std::log(2);
@@ -159,18 +185,30 @@ BasicBloomFilter::~BasicBloomFilter()
 void BasicBloomFilter::Add(const HashKey* key)
 	{
 	Hasher::digest_vector h = hasher->Hash(key);
-
-	for ( size_t i = 0; i < h.size(); ++i )
-		bits->Set(h[i] % bits->Size());
+	AddDigests(h.data());
 	}
 
 size_t BasicBloomFilter::Count(const HashKey* key) const
 	{
 	Hasher::digest_vector h = hasher->Hash(key);
+	return CountDigests(h.data());
+	}
+
+void BasicBloomFilter::AddDigests(const Hasher::digest* h)
+	{
+	size_t m = bits->Size();
+
+	for ( size_t i = 0; i < hasher->K(); ++i )
+		bits->Set(h[i] % m);
+	}
+
+size_t BasicBloomFilter::CountDigests(const Hasher::digest* h) const
+	{
+	size_t m = bits->Size();
 
-	for ( size_t i = 0; i < h.size(); ++i )
+	for ( size_t i = 0; i < hasher->K(); ++i )
 		{
-		if ( ! (*bits)[h[i] % bits->Size()] )
+		if ( ! (*bits)[h[i] % m] )
 			return 0;
 		}
 
@@ -263,21 +301,32 @@ std::string CountingBloomFilter::InternalState() const
 void CountingBloomFilter::Add(const HashKey* key)
 	{
 	Hasher::digest_vector h = hasher->Hash(key);
-
-	for ( size_t i = 0; i < h.size(); ++i )
-		cells->Increment(h[i] % cells->Size());
+	AddDigests(h.data());
 	}
 
 size_t CountingBloomFilter::Count(const HashKey* key) const
 	{
 	Hasher::digest_vector h = hasher->Hash(key);
+	return CountDigests(h.data());
+	}
+
+void CountingBloomFilter::AddDigests(const Hasher::digest* h)
+	{
+	CounterVector::size_type m = cells->Size();
 
+	for ( size_t i = 0; i < hasher->K(); ++i )
+		cells->Increment(h[i] % m);
+	}
+
+size_t CountingBloomFilter::CountDigests(const Hasher::digest* h) const
+	{
+	CounterVector::size_type m = cells->Size();
 	CounterVector::size_type min =
 		std::numeric_limits<CounterVector::size_type>::max();
 
-	for ( size_t i = 0; i < h.size(); ++i )
+	for ( size_t i = 0; i < hasher->K(); ++i )
 		{
-		CounterVector::size_type cnt = cells->Count(h[i] % cells->Size());
+		CounterVector::size_type cnt = cells->Count(h[i] % m);
 		if ( cnt  < min )
 			min = cnt;
 		}
@@ -46,6 +46,23 @@ public:
 	 */
 	virtual size_t Count(const HashKey* key) const = 0;
 
+	/**
+	 * Adds a batch of elements. This is equivalent to calling Add() for
+	 * each of them, but hashes all of them into the same buffer.
+	 *
+	 * @param keys The keys associated with the elements to add.
+	 */
+	void AddAll(const std::vector<HashKey*>& keys);
+
+	/**
+	 * Retrieves the associated counts of a batch of elements.
+	 *
+	 * @param keys The keys associated with the elements to check.
+	 *
+	 * @return The counters associated with the *keys*, in the same order.
+	 */
+	std::vector<size_t> CountAll(const std::vector<HashKey*>& keys) const;
+
 	/**
 	 * Checks whether the Bloom filter is empty.
 	 *
@@ -96,6 +113,17 @@ protected:
 	 */
 	explicit BloomFilter(const Hasher* hasher);
 
+	/**
+	 * Adds an element given the *k* hash values of its key.
+	 */
+	virtual void AddDigests(const Hasher::digest* h) = 0;
+
+	/**
+	 * Retrieves the count of an element given the *k* hash values of
+	 * its key.
+	 */
+	virtual size_t CountDigests(const Hasher::digest* h) const = 0;
+
 	virtual broker::expected<broker::data> DoSerialize() const = 0;
 	virtual bool DoUnserialize(const broker::data& data) = 0;
 	virtual BloomFilterType Type() const = 0;
@@ -170,6 +198,8 @@ protected:
 	// Overridden from BloomFilter.
 	void Add(const HashKey* key) override;
 	size_t Count(const HashKey* key) const override;
+	void AddDigests(const Hasher::digest* h) override;
+	size_t CountDigests(const Hasher::digest* h) const override;
 	broker::expected<broker::data> DoSerialize() const override;
 	bool DoUnserialize(const broker::data& data) override;
 	BloomFilterType Type() const override
@@ -219,6 +249,8 @@ protected:
 	// Overridden from BloomFilter.
 	void Add(const HashKey* key) override;
 	size_t Count(const HashKey* key) const override;
+	void AddDigests(const Hasher::digest* h) override;
+	size_t CountDigests(const Hasher::digest* h) const override;
 	broker::expected<broker::data> DoSerialize() const override;
 	bool DoUnserialize(const broker::data& data) override;
 	BloomFilterType Type() const override
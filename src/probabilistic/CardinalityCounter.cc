@@ -3,6 +3,8 @@
 #include "CardinalityCounter.h"
 
 #include <math.h>
+#include <algorithm>
+#include <array>
 #include <stdint.h>
 #include <utility>
 
@@ -117,6 +119,25 @@ CardinalityCounter::~CardinalityCounter()
 	{
 	}
 
+namespace {
+
+// 2^-i for all possible bucket values, so that estimating the size is a
+// plain sum over table lookups. The entries are exact, so this computes
+// the same result as calling pow() for every bucket.
+struct InversePowersOfTwo {
+	InversePowersOfTwo()
+		{
+		for ( size_t i = 0; i < table.size(); ++i )
+			table[i] = ldexp(1.0, -static_cast<int>(i));
+		}
+
+	std::array<double, 256> table;
+};
+
+const InversePowersOfTwo inverse_powers_of_two;
+
+}
+
 uint8_t CardinalityCounter::Rank(uint64_t hash_modified) const
 	{
 	hash_modified = hash_modified >> p;
@@ -140,6 +161,25 @@ void CardinalityCounter::AddElement(uint64_t hash)
 		buckets[index] = temp;
 	}
 
+void CardinalityCounter::AddElements(const uint64_t* hashes, size_t n)
+	{
+	// m is a power of two, so the bucket index is the hash's low p bits.
+	uint64_t mask = m - 1;
+	uint8_t* b = buckets.data();
+
+	for ( size_t i = 0; i < n; ++i )
+		{
+		uint64_t index = hashes[i] & mask;
+		uint8_t rank = Rank(hashes[i] - index);
+
+		if ( b[index] == 0 )
+			V--;
+
+		if ( rank > b[index] )
+			b[index] = rank;
+		}
+	}
+
 /**
  * Estimate the size by using the the "raw" HyperLogLog estimate. Then,
  * check if it's too "large" or "small" because the raw estimate doesn't
@@ -151,9 +191,11 @@ void CardinalityCounter::AddElement(uint64_t hash)
  **/
 double CardinalityCounter::Size() const
 	{
+	const auto& inv = inverse_powers_of_two.table;
 	double answer = 0;
+
 	for ( unsigned int i = 0; i < m; i++ )
-		answer += pow(2, -((int)buckets[i]));
+		answer += inv[buckets[i]];
 
 	answer = 1 / answer;
 	answer = (alpha_m * m * m * answer);
@@ -173,19 +215,19 @@ bool CardinalityCounter::Merge(CardinalityCounter* c)
 	if ( m != c->GetM() )
 		return false;
 
-	const std::vector<uint8_t>& temp = c->GetBuckets();
-
-	V = 0;
+	const uint8_t* temp = c->GetBuckets().data();
+	uint8_t* b = buckets.data();
+	uint64_t zeros = 0;
 
-	for ( unsigned int i = 0; i < m; i++ )
+	// Kept branch-free so that compilers turn this into vector
+	// instructions (e.g. a byte-wise max over 16 or 32 buckets at once).
+	for ( uint64_t i = 0; i < m; i++ )
 		{
-		if ( temp[i] > buckets[i] )
-			buckets[i] = temp[i];
-
-		if ( buckets[i] == 0 )
-			++V;
+		b[i] = std::max(b[i], temp[i]);
+		zeros += (b[i] == 0);
 		}
 
+	V = zeros;
 	return true;
 	}
 
@@ -282,6 +324,10 @@ std::unique_ptr<CardinalityCounter> CardinalityCounter::Unserialize(const broker
 int
 CardinalityCounter::flsll(uint64_t mask)
 {
+#if defined(__GNUC__) || defined(__clang__)
+        // Same result as the loop below, in a single instruction.
+        return mask ? 64 - __builtin_clzll(mask) : 0;
+#else
         int bit;
 
         if (mask == 0)
@@ -289,4 +335,5 @@ CardinalityCounter::flsll(uint64_t mask)
         for (bit = 1; mask != 1; bit++)
                 mask = (uint64_t)mask >> 1;
         return (bit);
+#endif
 }
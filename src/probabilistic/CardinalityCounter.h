@@ -70,6 +70,16 @@ public:
 	 */
 	void AddElement(uint64_t hash);
 
+	/**
+	 * Adds a batch of elements to the counter. This is equivalent to
+	 * calling AddElement() for each of them.
+	 *
+	 * @param hashes 64-bit hash values of the elements to be added
+	 *
+	 * @param n number of hash values
+	 */
+	void AddElements(const uint64_t* hashes, size_t n);
+
 	/**
 	 * Get the current estimated number of elements in the data
 	 * structure
@@ -36,23 +36,20 @@ bool CounterVector::Increment(size_type cell, count_type value)
 	assert(value != 0);
 
 	size_t lsb = cell * width;
-	bool carry = false;
+	count_type max = Max();
+	count_type cnt = bits->GetBits(lsb, width);
 
-	for ( size_t i = 0; i < width; ++i )
-		{
-		bool b1 = (*bits)[lsb + i];
-		bool b2 = value & (1 << i);
-		(*bits)[lsb + i] = b1 ^ b2 ^ carry;
-		carry = ( b1 && b2 ) || ( carry && ( b1 != b2 ) );
-		}
+	value &= max;
 
-	if ( carry )
+	if ( value > max - cnt )
 		{
-		for ( size_t i = 0; i < width; ++i )
-			bits->Set(lsb + i);
+		// Saturate on overflow.
+		bits->SetBits(lsb, width, max);
+		return false;
 		}
 
-	return ! carry;
+	bits->SetBits(lsb, width, cnt + value);
+	return true;
 	}
 
 bool CounterVector::Decrement(size_type cell, count_type value)
@@ -60,18 +57,17 @@ bool CounterVector::Decrement(size_type cell, count_type value)
 	assert(cell < Size());
 	assert(value != 0);
 
-	value = ~value + 1; // A - B := A + ~B + 1
-	bool carry = false;
 	size_t lsb = cell * width;
+	count_type max = Max();
+	count_type cnt = bits->GetBits(lsb, width);
 
-	for ( size_t i = 0; i < width; ++i )
-		{
-		bool b1 = (*bits)[lsb + i];
-		bool b2 = value & (1 << i);
-		(*bits)[lsb + i] = b1 ^ b2 ^ carry;
-		carry = ( b1 && b2 ) || ( carry && ( b1 != b2 ) );
-		}
+	// A - B := A + ~B + 1, truncated to the counter width.  The addition
+	// carries iff there was no underflow.
+	value = (~value + 1) & max;
+	count_type sum = cnt + value;
+	bool carry = width < 64 ? sum > max : sum < cnt;
 
+	bits->SetBits(lsb, width, sum);
 	return carry;
 	}
 
@@ -88,15 +84,7 @@ void CounterVector::Reset()
 CounterVector::count_type CounterVector::Count(size_type cell) const
 	{
 	assert(cell < Size());
-
-	size_t cnt = 0, order = 1;
-	size_t lsb = cell * width;
-
-	for ( size_t i = lsb; i < lsb + width; ++i, order <<= 1 )
-		if ( (*bits)[i] )
-			cnt |= order;
-
-	return cnt;
+	return bits->GetBits(cell * width, width);
 	}
 
 CounterVector::size_type CounterVector::Size() const
@@ -120,24 +108,16 @@ CounterVector& CounterVector::Merge(const CounterVector& other)
 	assert(Size() == other.Size());
 	assert(Width() == other.Width());
 
+	count_type max = Max();
+
 	for ( size_t cell = 0; cell < Size(); ++cell )
 		{
 		size_t lsb = cell * width;
-		bool carry = false;
-
-		for ( size_t i = 0; i < width; ++i )
-			{
-			bool b1 = (*bits)[lsb + i];
-			bool b2 = (*other.bits)[lsb + i];
-			(*bits)[lsb + i] = b1 ^ b2 ^ carry;
-			carry = ( b1 && b2 ) || ( carry && ( b1 != b2 ) );
-			}
-
-		if ( carry )
-			{
-			for ( size_t i = 0; i < width; ++i )
-				bits->Set(lsb + i);
-			}
+		count_type x = bits->GetBits(lsb, width);
+		count_type y = other.bits->GetBits(lsb, width);
+
+		// Saturate on overflow.
+		bits->SetBits(lsb, width, y > max - x ? max : x + y);
 		}
 
 	return *this;
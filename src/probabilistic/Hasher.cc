@@ -44,6 +44,11 @@ Hasher::digest_vector Hasher::Hash(const HashKey* key) const
 	return Hash(key->Key(), key->Size());
 	}
 
+void Hasher::Hash(const HashKey* key, digest* out) const
+	{
+	Hash(key->Key(), key->Size(), out);
+	}
+
 Hasher::Hasher(size_t arg_k, seed_t arg_seed)
 	{
 	k = arg_k;
@@ -124,13 +129,16 @@ DefaultHasher::DefaultHasher(size_t k, Hasher::seed_t seed)
 Hasher::digest_vector DefaultHasher::Hash(const void* x, size_t n) const
 	{
 	digest_vector h(K(), 0);
-
-	for ( size_t i = 0; i < h.size(); ++i )
-		h[i] = hash_functions[i](x, n);
-
+	Hash(x, n, h.data());
 	return h;
 	}
 
+void DefaultHasher::Hash(const void* x, size_t n, digest* out) const
+	{
+	for ( size_t i = 0; i < K(); ++i )
+		out[i] = hash_functions[i](x, n);
+	}
+
 DefaultHasher* DefaultHasher::Clone() const
 	{
 	return new DefaultHasher(*this);
@@ -152,14 +160,18 @@ DoubleHasher::DoubleHasher(size_t k, seed_t seed)
 
 Hasher::digest_vector DoubleHasher::Hash(const void* x, size_t n) const
 	{
-	digest d1 = h1(x, n);
-	digest d2 = h2(x, n);
 	digest_vector h(K(), 0);
+	Hash(x, n, h.data());
+	return h;
+	}
 
-	for ( size_t i = 0; i < h.size(); ++i )
-		h[i] = d1 + i * d2;
+void DoubleHasher::Hash(const void* x, size_t n, digest* out) const
+	{
+	digest d1 = h1(x, n);
+	digest d2 = h2(x, n);
 
-	return h;
+	for ( size_t i = 0; i < K(); ++i )
+		out[i] = d1 + i * d2;
 	}
 
 DoubleHasher* DoubleHasher::Clone() const
@@ -86,6 +86,28 @@ public:
 	 */
 	virtual digest_vector Hash(const void* x, size_t n) const = 0;
 
+	/**
+	 * Computes the hashes for a set of bytes into a caller-provided
+	 * buffer, which avoids allocating a vector per element when hashing
+	 * many elements in a row.
+	 *
+	 * @param x Pointer to first byte to hash.
+	 *
+	 * @param n Number of bytes to hash.
+	 *
+	 * @param out Array with room for *k* hash values.
+	 */
+	virtual void Hash(const void* x, size_t n, digest* out) const = 0;
+
+	/**
+	 * Computes hash values for an element into a caller-provided buffer.
+	 *
+	 * @param key The key of the value to hash.
+	 *
+	 * @param out Array with room for *k* hash values.
+	 */
+	void Hash(const HashKey* key, digest* out) const;
+
 	/**
 	 * Returns a deep copy of the hasher.
 	 */
@@ -215,6 +237,7 @@ public:
 
 	// Overridden from Hasher.
 	digest_vector Hash(const void* x, size_t n) const final;
+	void Hash(const void* x, size_t n, digest* out) const final;
 	DefaultHasher* Clone() const final;
 	bool Equals(const Hasher* other) const final;
 
@@ -244,6 +267,7 @@ public:
 
 	// Overridden from Hasher.
 	digest_vector Hash(const void* x, size_t n) const final;
+	void Hash(const void* x, size_t n, digest* out) const final;
 	DoubleHasher* Clone() const final;
 	bool Equals(const Hasher* other) const final;
 
@@ -2,27 +2,17 @@
 
 #include "probabilistic/Topk.h"
 
+#include <algorithm>
+
 #include <broker/error.hh>
 
 #include "broker/Data.h"
 #include "CompHash.h"
 #include "IntrusivePtr.h"
 #include "Reporter.h"
-#include "Dict.h"
 
 namespace probabilistic {
 
-static void topk_element_hash_delete_func(void* val)
-	{
-	Element* e = (Element*) val;
-	delete e;
-	}
-
-Element::~Element()
-	{
-	Unref(value);
-	}
-
 void TopkVal::Typify(BroType* t)
 	{
 	assert(!hash && !type);
@@ -32,49 +22,178 @@ void TopkVal::Typify(BroType* t)
 	hash = new CompositeHash(std::move(tl));
 	}
 
-HashKey* TopkVal::GetHash(Val* v) const
+std::string TopkVal::GetKey(Val* v) const
 	{
 	HashKey* key = hash->ComputeHash(v, true);
 	assert(key);
-	return key;
+	std::string rval(static_cast<const char*>(key->Key()), key->Size());
+	delete key;
+	return rval;
 	}
 
 TopkVal::TopkVal(uint64_t arg_size) : OpaqueVal(topk_type)
 	{
-	elementDict = new PDict<Element>;
-	elementDict->SetDeleteFunc(topk_element_hash_delete_func);
 	size = arg_size;
 	type = nullptr;
 	numElements = 0;
 	pruned = false;
 	hash = nullptr;
+	min_bucket = max_bucket = NIL;
 	}
 
 TopkVal::TopkVal() : OpaqueVal(topk_type)
 	{
-	elementDict = new PDict<Element>;
-	elementDict->SetDeleteFunc(topk_element_hash_delete_func);
 	size = 0;
 	type = nullptr;
 	numElements = 0;
+	pruned = false;
 	hash = nullptr;
+	min_bucket = max_bucket = NIL;
 	}
 
 TopkVal::~TopkVal()
 	{
-	elementDict->Clear();
-	delete elementDict;
+	for ( uint32_t b = min_bucket; b != NIL; b = buckets[b].next )
+		for ( uint32_t e = buckets[b].first; e != NIL; e = elements[e].next )
+			Unref(elements[e].value);
+
+	Unref(type);
+	delete hash;
+	}
+
+uint32_t TopkVal::Find(const std::string& key) const
+	{
+	auto it = index.find(key);
+
+	if ( it == index.end() )
+		return NIL;
+
+	return it->second;
+	}
+
+uint32_t TopkVal::NewElement(Val* value, std::string key, uint64_t epsilon)
+	{
+	uint32_t e;
 
-	// now all elements are already gone - delete the buckets
-	std::list<Bucket*>::iterator bi = buckets.begin();
-	while ( bi != buckets.end() )
+	if ( free_elements.empty() )
 		{
-		delete *bi;
-		bi++;
+		e = elements.size();
+		elements.emplace_back();
+		}
+	else
+		{
+		e = free_elements.back();
+		free_elements.pop_back();
 		}
 
-	Unref(type);
-	delete hash;
+	auto it = index.emplace(std::move(key), e).first;
+
+	Element& el = elements[e];
+	el.epsilon = epsilon;
+	el.value = value->Ref();
+	el.key = &it->first;
+	el.bucket = el.prev = el.next = NIL;
+	return e;
+	}
+
+void TopkVal::DeleteElement(uint32_t e, bool release_empty)
+	{
+	Unlink(e, release_empty);
+
+	Element& el = elements[e];
+	index.erase(*el.key);
+	Unref(el.value);
+	el.value = nullptr;
+	el.key = nullptr;
+	free_elements.push_back(e);
+	}
+
+uint32_t TopkVal::NewBucket(uint64_t count, uint32_t before)
+	{
+	uint32_t b;
+
+	if ( free_buckets.empty() )
+		{
+		b = buckets.size();
+		buckets.emplace_back();
+		}
+	else
+		{
+		b = free_buckets.back();
+		free_buckets.pop_back();
+		}
+
+	Bucket& bu = buckets[b];
+	bu.count = count;
+	bu.size = 0;
+	bu.first = bu.last = NIL;
+	bu.next = before;
+	bu.prev = before == NIL ? max_bucket : buckets[before].prev;
+
+	if ( bu.prev == NIL )
+		min_bucket = b;
+	else
+		buckets[bu.prev].next = b;
+
+	if ( before == NIL )
+		max_bucket = b;
+	else
+		buckets[before].prev = b;
+
+	return b;
+	}
+
+void TopkVal::Append(uint32_t b, uint32_t e)
+	{
+	Bucket& bu = buckets[b];
+	Element& el = elements[e];
+
+	el.bucket = b;
+	el.prev = bu.last;
+	el.next = NIL;
+
+	if ( bu.last == NIL )
+		bu.first = e;
+	else
+		elements[bu.last].next = e;
+
+	bu.last = e;
+	bu.size++;
+	}
+
+void TopkVal::Unlink(uint32_t e, bool release_empty)
+	{
+	Element& el = elements[e];
+	uint32_t b = el.bucket;
+	Bucket& bu = buckets[b];
+
+	if ( el.prev == NIL )
+		bu.first = el.next;
+	else
+		elements[el.prev].next = el.next;
+
+	if ( el.next == NIL )
+		bu.last = el.prev;
+	else
+		elements[el.next].prev = el.prev;
+
+	el.bucket = el.prev = el.next = NIL;
+	bu.size--;
+
+	if ( bu.size > 0 || ! release_empty )
+		return;
+
+	if ( bu.prev == NIL )
+		min_bucket = bu.next;
+	else
+		buckets[bu.prev].next = bu.next;
+
+	if ( bu.next == NIL )
+		max_bucket = bu.prev;
+	else
+		buckets[bu.next].prev = bu.prev;
+
+	free_buckets.push_back(b);
 	}
 
 void TopkVal::Merge(const TopkVal* value, bool doPrune)
@@ -101,54 +220,90 @@ void TopkVal::Merge(const TopkVal* value, bool doPrune)
 			}
 		}
 
-	std::list<Bucket*>::const_iterator it = value->buckets.begin();
-	while ( it != value->buckets.end() )
+	// Adding the other structure's elements one at a time would move each
+	// of them through our bucket list individually. Instead, sum up the
+	// counts first and then rebuild the buckets in a single pass. The
+	// order of elements within a bucket is the same as if they had been
+	// added individually: elements that the merge doesn't touch keep
+	// their place in front of those it moves there, and the latter are
+	// ordered like in the other structure.
+	std::vector<uint64_t> counts(elements.size());
+	std::vector<uint32_t> order;
+	std::vector<uint32_t> touched;
+	std::vector<bool> is_touched(elements.size());
+
+	for ( uint32_t b = min_bucket; b != NIL; b = buckets[b].next )
+		for ( uint32_t e = buckets[b].first; e != NIL; e = elements[e].next )
+			counts[e] = buckets[b].count;
+
+	// Snapshot the other side first, it may be ourselves.
+	struct Incoming {
+		uint32_t e;
+		uint64_t count;
+		uint64_t epsilon;
+	};
+
+	std::vector<Incoming> incoming;
+	incoming.reserve(value->numElements);
+
+	for ( uint32_t b = value->min_bucket; b != NIL; b = value->buckets[b].next )
+		for ( uint32_t e = value->buckets[b].first; e != NIL; e = value->elements[e].next )
+			incoming.push_back({e, value->buckets[b].count, value->elements[e].epsilon});
+
+	touched.reserve(incoming.size());
+
+	for ( const auto& in : incoming )
 		{
-		Bucket* b = *it;
-		uint64_t currcount = b->count;
-		std::list<Element*>::const_iterator eit = b->elements.begin();
+		// Keys of both sides are computed from identical types and
+		// thus directly comparable.
+		const Element& other = value->elements[in.e];
+		uint32_t e = Find(*other.key);
+
+		if ( e == NIL )
+			{
+			e = NewElement(other.value, *other.key, 0);
+			numElements++;
+			}
 
-		while ( eit != b->elements.end() )
+		if ( e >= counts.size() )
 			{
-			Element* e = *eit;
-			// lookup if we already know this one...
-			HashKey* key = GetHash(e->value);
-			Element* olde = (Element*) elementDict->Lookup(key);
-
-			if ( olde == nullptr )
-				{
-				olde = new Element();
-				olde->epsilon = 0;
-				olde->value = e->value->Ref();
-				// insert at bucket position 0
-				if ( buckets.size() > 0 )
-					{
-					assert (buckets.front()-> count > 0 );
-					}
-
-				Bucket* newbucket = new Bucket();
-				newbucket->count = 0;
-				newbucket->bucketPos = buckets.insert(buckets.begin(), newbucket);
-
-				olde->parent = newbucket;
-				newbucket->elements.insert(newbucket->elements.end(), olde);
-
-				elementDict->Insert(key, olde);
-				numElements++;
-
-				}
-
-			// now that we are sure that the old element is present - increment epsilon
-			olde->epsilon += e->epsilon;
-
-			// and increment position...
-			IncrementCounter(olde, currcount);
-			delete key;
-
-			eit++;
+			counts.resize(e + 1);
+			is_touched.resize(e + 1);
 			}
 
-		it++;
+		elements[e].epsilon += in.epsilon;
+		counts[e] += in.count;
+
+		if ( ! is_touched[e] )
+			{
+			is_touched[e] = true;
+			touched.push_back(e);
+			}
+		}
+
+	order.reserve(numElements);
+
+	for ( uint32_t b = min_bucket; b != NIL; b = buckets[b].next )
+		for ( uint32_t e = buckets[b].first; e != NIL; e = elements[e].next )
+			if ( ! is_touched[e] )
+				order.push_back(e);
+
+	order.insert(order.end(), touched.begin(), touched.end());
+
+	std::stable_sort(order.begin(), order.end(),
+	                 [&counts](uint32_t a, uint32_t b)
+	                 { return counts[a] < counts[b]; });
+
+	buckets.clear();
+	free_buckets.clear();
+	min_bucket = max_bucket = NIL;
+
+	for ( auto e : order )
+		{
+		if ( max_bucket == NIL || buckets[max_bucket].count != counts[e] )
+			NewBucket(counts[e], NIL);
+
+		Append(max_bucket, e);
 		}
 
 	// now we have added everything. And our top-k table could be too big.
@@ -162,24 +317,8 @@ void TopkVal::Merge(const TopkVal* value, bool doPrune)
 	while ( numElements > size )
 		{
 		pruned = true;
-		assert(buckets.size() > 0 );
-		Bucket* b = buckets.front();
-		assert(b->elements.size() > 0);
-
-		Element* e = b->elements.front();
-		HashKey* key = GetHash(e->value);
-		elementDict->RemoveEntry(key);
-		delete key;
-		delete e;
-
-		b->elements.pop_front();
-
-		if ( b->elements.size() == 0 )
-			{
-			delete b;
-			buckets.pop_front();
-			}
-
+		assert(min_bucket != NIL);
+		DeleteElement(buckets[min_bucket].first);
 		numElements--;
 		}
 	}
@@ -208,25 +347,10 @@ VectorVal* TopkVal::GetTopK(int k) const // returns vector
 	// in any case - just to make this future-proof (and I am lazy) - this can return more than k.
 
 	int read = 0;
-	std::list<Bucket*>::const_iterator it = buckets.end();
-	it--;
-	while (read < k )
-		{
-		//printf("Bucket %llu\n", (*it)->count);
-		std::list<Element*>::iterator eit = (*it)->elements.begin();
-		while ( eit != (*it)->elements.end() )
-			{
-			//printf("Size: %ld\n", (*it)->elements.size());
-			t->Assign(read, (*eit)->value->Ref());
-			read++;
-			eit++;
-			}
 
-		if ( it == buckets.begin() )
-			break;
-
-		it--;
-		}
+	for ( uint32_t b = max_bucket; b != NIL && read < k; b = buckets[b].prev )
+		for ( uint32_t e = buckets[b].first; e != NIL; e = elements[e].next )
+			t->Assign(read++, elements[e].value->Ref());
 
 	Unref(v);
 	return t;
@@ -234,45 +358,36 @@ VectorVal* TopkVal::GetTopK(int k) const // returns vector
 
 uint64_t TopkVal::GetCount(Val* value) const
 	{
-	HashKey* key = GetHash(value);
-	Element* e = (Element*) elementDict->Lookup(key);
-	delete key;
+	uint32_t e = Find(GetKey(value));
 
-	if ( e == nullptr )
+	if ( e == NIL )
 		{
 		reporter->Error("GetCount for element that is not in top-k");
 		return 0;
 		}
 
-	return e->parent->count;
+	return buckets[elements[e].bucket].count;
 	}
 
 uint64_t TopkVal::GetEpsilon(Val* value) const
 	{
-	HashKey* key = GetHash(value);
-	Element* e = (Element*) elementDict->Lookup(key);
-	delete key;
+	uint32_t e = Find(GetKey(value));
 
-	if ( e == nullptr )
+	if ( e == NIL )
 		{
 		reporter->Error("GetEpsilon for element that is not in top-k");
 		return 0;
 		}
 
-	return e->epsilon;
+	return elements[e].epsilon;
 	}
 
 uint64_t TopkVal::GetSum() const
 	{
 	uint64_t sum = 0;
 
-	std::list<Bucket*>::const_iterator it = buckets.begin();
-	while ( it != buckets.end() )
-		{
-		sum += (*it)->elements.size() * (*it)->count;
-
-		it++;
-		}
+	for ( uint32_t b = min_bucket; b != NIL; b = buckets[b].next )
+		sum += buckets[b].size * buckets[b].count;
 
 	if ( pruned )
 		reporter->Warning("TopkVal::GetSum() was used on a pruned data structure. Result values do not represent total element count");
@@ -294,119 +409,65 @@ void TopkVal::Encountered(Val* encountered)
 			}
 
 	// Step 1 - get the hash.
-	HashKey* key = GetHash(encountered);
-	Element* e = (Element*) elementDict->Lookup(key);
+	std::string key = GetKey(encountered);
+	uint32_t e = Find(key);
 
-	if ( e == nullptr )
+	if ( e == NIL )
 		{
-		e = new Element();
-		e->epsilon = 0;
-		e->value = encountered->Ref(); // or no ref?
-
 		// well, we do not know this one yet...
 		if ( numElements < size )
 			{
 			// brilliant. just add it at position 1
-			if ( buckets.size() == 0 || (*buckets.begin())->count > 1 )
-				{
-				Bucket* b = new Bucket();
-				b->count = 1;
-				std::list<Bucket*>::iterator pos = buckets.insert(buckets.begin(), b);
-				b->bucketPos = pos;
-				b->elements.insert(b->elements.end(), e);
-				e->parent = b;
-				}
-			else
-				{
-				Bucket* b = *buckets.begin();
-				assert(b->count == 1);
-				b->elements.insert(b->elements.end(), e);
-				e->parent = b;
-				}
-
-			elementDict->Insert(key, e);
-			numElements++;
-			delete key;
+			if ( min_bucket == NIL || buckets[min_bucket].count > 1 )
+				NewBucket(1, min_bucket);
 
+			assert(buckets[min_bucket].count == 1);
+			Append(min_bucket, NewElement(encountered, std::move(key), 0));
+			numElements++;
 			return; // done. it is at pos 1.
 			}
 
-		else
-			{
-			// replace element with min-value
-			Bucket* b = *buckets.begin(); // bucket with smallest elements
-
-			// evict oldest element with least hits.
-			assert(b->elements.size() > 0);
-			HashKey* deleteKey = GetHash((*(b->elements.begin()))->value);
-			b->elements.erase(b->elements.begin());
-			Element* deleteElement = (Element*) elementDict->RemoveEntry(deleteKey);
-			assert(deleteElement); // there has to have been a minimal element...
-			delete deleteElement;
-			delete deleteKey;
-
-			// and add the new one to the end
-			e->epsilon = b->count;
-			b->elements.insert(b->elements.end(), e);
-			elementDict->Insert(key, e);
-			e->parent = b;
-
-			// fallthrough, increment operation has to run!
-			}
+		// replace element with min-value
+		uint32_t b = min_bucket; // bucket with smallest elements
+
+		// evict oldest element with least hits. The bucket stays
+		// around even if it's empty now, the new element goes there.
+		uint32_t victim = buckets[b].first;
+		assert(victim != NIL); // there has to have been a minimal element...
+		DeleteElement(victim, false);
 
+		// and add the new one to the end
+		e = NewElement(encountered, std::move(key), buckets[b].count);
+		Append(b, e);
+
+		// fallthrough, increment operation has to run!
 		}
 
 	// ok, we now have an element in e
-	delete key;
 	IncrementCounter(e); // well, this certainly was anticlimatic.
 	}
 
 // increment by count
-void TopkVal::IncrementCounter(Element* e, unsigned int count)
+void TopkVal::IncrementCounter(uint32_t e, uint64_t count)
 	{
-	Bucket* currBucket = e->parent;
-	uint64_t currcount = currBucket->count;
+	uint32_t currBucket = elements[e].bucket;
+	uint64_t target = buckets[currBucket].count + count;
 
-	// well, let's test if there is a bucket for currcount++
-	std::list<Bucket*>::iterator bucketIter = currBucket->bucketPos;
+	// well, let's test if there is a bucket for currcount + count
+	uint32_t nextBucket = buckets[currBucket].next;
 
-	Bucket* nextBucket = nullptr;
+	while ( nextBucket != NIL && buckets[nextBucket].count < target )
+		nextBucket = buckets[nextBucket].next;
 
-	bucketIter++;
-
-	while ( bucketIter != buckets.end() && (*bucketIter)->count < currcount+count )
-		bucketIter++;
-
-	if ( bucketIter != buckets.end() && (*bucketIter)->count == currcount+count )
-		nextBucket = *bucketIter;
-
-	if ( nextBucket == nullptr )
-		{
+	if ( nextBucket == NIL || buckets[nextBucket].count != target )
 		// the bucket for the value that we want does not exist.
 		// create it...
+		nextBucket = NewBucket(target, nextBucket);
 
-		Bucket* b = new Bucket();
-		b->count = currcount+count;
-
-		std::list<Bucket*>::iterator nextBucketPos = buckets.insert(bucketIter, b);
-		b->bucketPos = nextBucketPos; // and give it the iterator we know now.
-
-		nextBucket = b;
-		}
-
-	// ok, now we have the new bucket in nextBucket. Shift the element over...
-	currBucket->elements.remove(e);
-	nextBucket->elements.insert(nextBucket->elements.end(), e);
-
-	e->parent = nextBucket;
-
-	// if currBucket is empty, we have to delete it now
-	if ( currBucket->elements.size() == 0 )
-		{
-		buckets.remove(currBucket);
-		delete currBucket;
-		currBucket = nullptr;
-		}
+	// ok, now we have the new bucket in nextBucket. Shift the element
+	// over, deleting the current bucket if that empties it.
+	Unlink(e, true);
+	Append(nextBucket, e);
 	}
 
 IMPLEMENT_OPAQUE_VALUE(TopkVal)
@@ -427,31 +488,22 @@ broker::expected<broker::data> TopkVal::DoSerialize() const
 		d.emplace_back(broker::none());
 
 	uint64_t i = 0;
-	std::list<Bucket*>::const_iterator it = buckets.begin();
-	while ( it != buckets.end() )
-		{
-		Bucket* b = *it;
-		uint32_t elements_count = b->elements.size();
 
-		d.emplace_back(static_cast<uint64_t>(b->elements.size()));
-		d.emplace_back(b->count);
+	for ( uint32_t b = min_bucket; b != NIL; b = buckets[b].next )
+		{
+		d.emplace_back(static_cast<uint64_t>(buckets[b].size));
+		d.emplace_back(buckets[b].count);
 
-		std::list<Element*>::const_iterator eit = b->elements.begin();
-		while ( eit != b->elements.end() )
+		for ( uint32_t e = buckets[b].first; e != NIL; e = elements[e].next )
 			{
-			Element* element = *eit;
-			d.emplace_back(element->epsilon);
-			auto v = bro_broker::val_to_data(element->value);
+			d.emplace_back(elements[e].epsilon);
+			auto v = bro_broker::val_to_data(elements[e].value);
 			if ( ! v )
 				return broker::ec::invalid_data;
 
 			d.emplace_back(*v);
-
-			eit++;
 			i++;
 			}
-
-		it++;
 		}
 
 	assert(i == numElements);
@@ -499,9 +551,7 @@ bool TopkVal::DoUnserialize(const broker::data& data)
 		if ( ! (elements_count && count) )
 			return false;
 
-		Bucket* b = new Bucket();
-		b->count = *count;
-		b->bucketPos = buckets.insert(buckets.end(), b);
+		uint32_t b = NewBucket(*count, NIL);
 
 		for ( uint64_t j = 0; j < *elements_count; j++ )
 			{
@@ -511,19 +561,10 @@ bool TopkVal::DoUnserialize(const broker::data& data)
 			if ( ! (epsilon && val) )
 				return false;
 
-			Element* e = new Element();
-			e->epsilon = *epsilon;
-			e->value = val.release();
-			e->parent = b;
-
-			b->elements.insert(b->elements.end(), e);
-
-			HashKey* key = GetHash(e->value);
-			assert (elementDict->Lookup(key) == nullptr);
-
-			elementDict->Insert(key, e);
-			delete key;
+			std::string key = GetKey(val.get());
+			assert(Find(key) == NIL);
 
+			Append(b, NewElement(val.get(), std::move(key), *epsilon));
 			i++;
 			}
 		}
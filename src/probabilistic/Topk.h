@@ -2,35 +2,41 @@
 
 #pragma once
 
-#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include "Val.h"
 #include "OpaqueVal.h"
 
 // This class implements the top-k algorithm. Or - to be more precise - an
 // interpretation of it.
+//
+// Elements and the buckets grouping them by count live in two flat arrays
+// and refer to each other by index, so that tracking a value doesn't need
+// any allocations once the arrays have grown to their working size. Slots
+// of evicted elements and emptied buckets get reused.
 
 class CompositeHash;
 
 namespace probabilistic {
 
-struct Element;
-
-struct Bucket {
-	uint64_t count;
-	std::list<Element*> elements;
-
-	// Iterators only get invalidated for removed elements. This one
-	// points to us - so it is invalid when we are no longer there. Cute,
-	// isn't it?
-	std::list<Bucket*>::iterator bucketPos;
-};
-
 struct Element {
 	uint64_t epsilon;
 	Val* value;
-	Bucket* parent;
+	const std::string* key; // points into TopkVal's index
+	uint32_t bucket;
+	uint32_t prev; // neighbors within the bucket, oldest first
+	uint32_t next;
+};
 
-	~Element();
+struct Bucket {
+	uint64_t count;
+	uint32_t size; // number of elements
+	uint32_t first;
+	uint32_t last;
+	uint32_t prev; // neighbors in order of ascending count
+	uint32_t next;
 };
 
 class TopkVal : public OpaqueVal {
@@ -145,16 +151,61 @@ private:
 	 *
 	 * @param count increment counter by this much
 	 */
-	void IncrementCounter(Element* e, unsigned int count = 1);
+	void IncrementCounter(uint32_t e, uint64_t count = 1);
 
 	/**
-	 * get the hashkey for a specific value
+	 * Looks up the element tracking a value.
+	 *
+	 * @param key the key bytes of the value
+	 *
+	 * @returns index of the element, or NIL if the value isn't tracked
+	 */
+	uint32_t Find(const std::string& key) const;
+
+	/**
+	 * Creates a new element that isn't part of any bucket yet.
+	 *
+	 * @returns index of the element
+	 */
+	uint32_t NewElement(Val* value, std::string key, uint64_t epsilon);
+
+	/**
+	 * Removes an element from its bucket and releases it, releasing the
+	 * bucket as well if it becomes empty and release_empty is set.
+	 */
+	void DeleteElement(uint32_t e, bool release_empty = true);
+
+	/**
+	 * Creates a new, empty bucket.
+	 *
+	 * @param count the count of the bucket
+	 *
+	 * @param before the bucket to insert the new one in front of, or NIL
+	 * to append it
+	 *
+	 * @returns index of the bucket
+	 */
+	uint32_t NewBucket(uint64_t count, uint32_t before);
+
+	/**
+	 * Appends an element to a bucket.
+	 */
+	void Append(uint32_t b, uint32_t e);
+
+	/**
+	 * Removes an element from its bucket, releasing the bucket if it
+	 * becomes empty and release_empty is set.
+	 */
+	void Unlink(uint32_t e, bool release_empty);
+
+	/**
+	 * get the hash key bytes for a specific value
 	 *
 	 * @param v value to generate key for
 	 *
-	 * @returns HashKey for value
+	 * @returns key bytes for value
 	 */
-	HashKey* GetHash(Val* v) const; // this probably should go somewhere else.
+	std::string GetKey(Val* v) const; // this probably should go somewhere else.
 
 	/**
 	 * Set the type that this TopK instance tracks
@@ -165,11 +216,18 @@ private:
 
 	BroType* type;
 	CompositeHash* hash;
-	std::list<Bucket*> buckets;
-	PDict<Element>* elementDict;
+	std::vector<Element> elements;
+	std::vector<Bucket> buckets;
+	std::vector<uint32_t> free_elements;
+	std::vector<uint32_t> free_buckets;
+	std::unordered_map<std::string, uint32_t> index;
+	uint32_t min_bucket; // bucket with the smallest count
+	uint32_t max_bucket; // bucket with the largest count
 	uint64_t size; // how many elements are we tracking?
 	uint64_t numElements; // how many elements do we have at the moment
 	bool pruned; // was this data structure pruned?
+
+	static constexpr uint32_t NIL = UINT32_MAX;
 };
 
 };
@@ -9,8 +9,11 @@
 #include <signal.h>
 #include <string.h>
 #include <sys/types.h>
+#include <algorithm>
 #include <list>
 #include <optional>
+#include <utility>
+#include <vector>
 
 #ifdef USE_IDMEF
 extern "C" {
@@ -42,6 +45,8 @@ extern "C" {
 #include "EventRegistry.h"
 #include "Stats.h"
 #include "Brofiler.h"
+#include "ScriptProfiler.h"
+#include "Reduce.h"
 #include "Traverse.h"
 #include "Trigger.h"
 #include "Hash.h"
@@ -276,6 +281,8 @@ void terminate_bro()
 	timer_mgr->Expire();
 	mgr.Drain();
 
+	script_profiler.DoneFromEnv();
+
 	if ( profiling_logger )
 		{
 		// FIXME: There are some occasional crashes in the memory
@@ -465,6 +472,17 @@ zeek::detail::SetupResult zeek::detail::setup(int argc, char** argv,
 
 	bro_start_time = current_time(true);
 
+	// Durations of the phases of startup, reported with -Q.
+	std::vector<std::pair<const char*, double>> startup_phases;
+	double phase_start = bro_start_time;
+
+	auto end_phase = [&](const char* name)
+		{
+		double now = current_time(true);
+		startup_phases.emplace_back(name, now - phase_start);
+		phase_start = now;
+		};
+
 	val_mgr = new ValManager();
 	reporter = new Reporter(options.abort_on_scripting_errors);
 	thread_mgr = new threading::Manager();
@@ -616,6 +634,8 @@ zeek::detail::SetupResult zeek::detail::setup(int argc, char** argv,
 	HeapLeakChecker::Disabler disabler;
 #endif
 
+	end_phase("pre-script");
+
 	is_parsing = true;
 	yyparse();
 	is_parsing = false;
@@ -623,6 +643,8 @@ zeek::detail::SetupResult zeek::detail::setup(int argc, char** argv,
 	RecordVal::DoneParsing();
 	TableVal::DoneParsing();
 
+	end_phase("parsing");
+
 	init_general_global_var();
 	init_net_var();
 	init_builtin_funcs_subdirs();
@@ -796,6 +818,20 @@ zeek::detail::SetupResult zeek::detail::setup(int argc, char** argv,
 		// we don't have any other source for it.
 		net_update_time(current_time());
 
+	end_phase("post-script");
+
+	// Only now, with the command line reflected in all script-level
+	// constants, does reducing the scripts not change their meaning.
+	if ( options.optimize_scripts )
+		{
+		Reducer reducer;
+		reducer.ReduceGlobalFunctions(options.dump_optimized_scripts ?
+		                              stdout : nullptr);
+		end_phase("optimize");
+		}
+
+	script_profiler.InitFromEnv();
+
 	EventHandlerPtr zeek_init = internal_handler("zeek_init");
 	if ( zeek_init )	//### this should be a function
 		mgr.Enqueue(zeek_init, zeek::Args{});
@@ -857,6 +893,18 @@ zeek::detail::SetupResult zeek::detail::setup(int argc, char** argv,
 	// Drain the event queue here to support the protocols framework configuring DPM
 	mgr.Drain();
 
+	end_phase("zeek_init");
+
+	if ( options.print_execution_time )
+		{
+		for ( const auto& p : startup_phases )
+			fprintf(stderr, "# startup %s %.6f\n", p.first, p.second);
+
+		auto loaded = std::count_if(files_scanned.begin(), files_scanned.end(),
+		                            [](const ScannedFile& sf) { return ! sf.skipped; });
+		fprintf(stderr, "# startup scripts %zd\n", loaded);
+		}
+
 	if ( reporter->Errors() > 0 && ! zeekenv("ZEEK_ALLOW_INIT_ERRORS") )
 		reporter->FatalError("errors occurred while initializing");
 
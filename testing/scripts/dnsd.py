@@ -0,0 +1,72 @@
+#! /usr/bin/env python
+#
+# A minimal DNS server for testing Zeek's internal resolver.  It answers PTR
+# queries for the names given on the command line and NXDOMAIN for anything
+# else, printing each query it receives.
+
+import socket
+import struct
+import sys
+
+def parse_name(msg, off):
+    labels = []
+
+    while True:
+        n = ord(msg[off:off + 1])
+        off += 1
+
+        if n == 0:
+            break
+
+        labels.append(msg[off:off + n].decode("ascii"))
+        off += n
+
+    return ".".join(labels), off
+
+def encode_name(name):
+    rval = b""
+
+    for label in name.split("."):
+        rval += struct.pack("!B", len(label)) + label.encode("ascii")
+
+    return rval + b"\0"
+
+def reply(msg, ptrs, ttl):
+    qid, flags = struct.unpack("!HH", msg[:4])
+    name, off = parse_name(msg, 12)
+    qtype, qclass = struct.unpack("!HH", msg[off:off + 4])
+    question = msg[12:off + 4]
+
+    print("%s %d" % (name, qtype))
+    sys.stdout.flush()
+
+    # QR, opcode and RD copied from the query, RA set.
+    flags = 0x8000 | (flags & 0x7900) | 0x0080
+
+    if qtype == 12 and name in ptrs:
+        answer = struct.pack("!HHHIH", 0xc00c, 12, 1, ttl, 0)
+        rdata = encode_name(ptrs[name])
+        answer = answer[:-2] + struct.pack("!H", len(rdata)) + rdata
+        return struct.pack("!HHHHHH", qid, flags, 1, 1, 0, 0) + question + answer
+
+    return struct.pack("!HHHHHH", qid, flags | 3, 1, 0, 0, 0) + question
+
+if __name__ == "__main__":
+    from optparse import OptionParser
+    p = OptionParser(usage="%prog [options] [reverse-name=host ...]")
+    p.add_option("-a", "--addr", type="string", default="127.0.0.1",
+                 help="listen on given address")
+    p.add_option("-p", "--port", type="int", default=32153,
+                 help="listen on given UDP port number")
+    p.add_option("-t", "--ttl", type="int", default=300,
+                 help="TTL of the answers")
+    options, args = p.parse_args()
+
+    ptrs = dict(arg.split("=", 1) for arg in args)
+
+    s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    s.bind((options.addr, options.port))
+
+    while True:
+        msg, peer = s.recvfrom(512)
+        s.sendto(reply(msg, ptrs, options.ttl), peer)